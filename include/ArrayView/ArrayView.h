@@ -48,7 +48,7 @@ class ArrayView {
 
   ArrayView(std::size_t length, T* pointer)
       : length_{length}, pointer_{pointer} {
-    assert(length >= 0);
+    assert(pointer != nullptr || length == 0);
   }
 };
 #endif
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2020 ElectroOptical Innovations, LLC
+ *
+ * BitField for flags shared between threads or with interrupt handlers.
+ * Every update is a single atomic read-modify-write on a 64 bit word so
+ * concurrent writers never lose each other's bits and no lock is taken.
+ * Ranges that cross a word boundary are updated one word at a time, each
+ * word atomically.
+ * */
+#pragma once
+#ifndef BITCONTROL_ATOMICBITFIELD_H_
+#define BITCONTROL_ATOMICBITFIELD_H_
+
+#include <BitControl/BitField.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+
+template <std::size_t kElements>
+class AtomicBitField {
+  static const constexpr std::size_t kWordBits = BitFieldWords::kWordBits;
+  static const constexpr std::size_t kWordCount =
+      BitField<kElements>::GetWordCount();
+
+  std::array<std::atomic<uint64_t>, kWordCount> data_store_{};
+
+  static constexpr std::size_t GetWordIndex(const std::size_t address) {
+    return address / kWordBits;
+  }
+  static constexpr uint64_t GetBitMask(const std::size_t address) {
+    return uint64_t{1} << (address % kWordBits);
+  }
+
+ public:
+  static constexpr std::size_t GetSize(void) { return kElements; }
+  static constexpr std::size_t size(void) { return GetSize(); }
+
+  bool ReadElement(const uint16_t address) const {
+    return data_store_[GetWordIndex(address)].load(std::memory_order_acquire) &
+           GetBitMask(address);
+  }
+
+  void WriteElement(const uint16_t address, const bool state) {
+    if (state) {
+      test_and_set(address);
+    } else {
+      test_and_clear(address);
+    }
+  }
+
+  /*
+   * Set the element and return its previous state, exactly one of several
+   * racing callers sees false
+   * */
+  bool test_and_set(const uint16_t address) {
+    assert(address < kElements);
+    const uint64_t mask = GetBitMask(address);
+    return data_store_[GetWordIndex(address)].fetch_or(
+               mask, std::memory_order_acq_rel) &
+           mask;
+  }
+
+  bool test_and_clear(const uint16_t address) {
+    assert(address < kElements);
+    const uint64_t mask = GetBitMask(address);
+    return data_store_[GetWordIndex(address)].fetch_and(
+               ~mask, std::memory_order_acq_rel) &
+           mask;
+  }
+
+  /*
+   * Or the low count (up to 64) bits of value into the range starting at
+   * start, returns the previous state of the range
+   * */
+  uint64_t fetch_or(const std::size_t start, const std::size_t count,
+                    const uint64_t value) {
+    assert(count <= kWordBits);
+    assert(start + count <= kElements);
+    const uint64_t bits = value & BitFieldWords::GetLowMask(count);
+    uint64_t previous = 0;
+    BitFieldWords::ForEachWord(
+        start, count, [&](const std::size_t word, const uint64_t mask) {
+          //  word holds elements [word * 64, word * 64 + 64)
+          const std::size_t first = std::max(start, word * kWordBits);
+          const std::size_t offset = first - start;
+          const std::size_t shift = first % kWordBits;
+          const uint64_t update = (bits >> offset) << shift;
+          const uint64_t old = data_store_[word].fetch_or(
+              update & mask, std::memory_order_acq_rel);
+          previous |= ((old & mask) >> shift) << offset;
+        });
+    return previous;
+  }
+
+  void SetRange(const std::size_t start, const std::size_t count) {
+    assert(start + count <= kElements);
+    BitFieldWords::ForEachWord(
+        start, count, [this](const std::size_t word, const uint64_t mask) {
+          data_store_[word].fetch_or(mask, std::memory_order_acq_rel);
+        });
+  }
+
+  void ClearRange(const std::size_t start, const std::size_t count) {
+    assert(start + count <= kElements);
+    BitFieldWords::ForEachWord(
+        start, count, [this](const std::size_t word, const uint64_t mask) {
+          data_store_[word].fetch_and(~mask, std::memory_order_acq_rel);
+        });
+  }
+
+  /*
+   * Copy into a plain BitField for reading or serializing, each word is
+   * loaded atomically but the words are not read as one transaction
+   * */
+  void snapshot(BitField<kElements> *const out) const {
+    for (std::size_t word = 0; word < kWordCount; word++) {
+      out->WriteWord(word, data_store_[word].load(std::memory_order_acquire));
+    }
+  }
+
+  BitField<kElements> snapshot(void) const {
+    BitField<kElements> out{};
+    snapshot(&out);
+    return out;
+  }
+
+  /*
+   * Return the current state and clear it, each word is exchanged atomically
+   * so no flag raised during the call is lost
+   * */
+  BitField<kElements> exchange_clear(void) {
+    BitField<kElements> out{};
+    for (std::size_t word = 0; word < kWordCount; word++) {
+      out.WriteWord(word,
+                    data_store_[word].exchange(0, std::memory_order_acq_rel));
+    }
+    return out;
+  }
+
+  constexpr AtomicBitField(void) {}
+  AtomicBitField(const AtomicBitField &) = delete;
+  AtomicBitField operator=(const AtomicBitField &) = delete;
+};
+
+#endif  //  BITCONTROL_ATOMICBITFIELD_H_
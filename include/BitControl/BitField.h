@@ -1,75 +1,313 @@
+/*
+ * Copyright 2020 ElectroOptical Innovations, LLC
+ *
+ * Fixed size bit array stored in 64 bit words, element 0 is bit 0 of word 0.
+ * Bits above kElements in the last word are kept clear so counts and
+ * searches never see them. Ranges that straddle a word are read and written
+ * with a funnel shift of the two words.
+ * */
+#pragma once
+#ifndef BITCONTROL_BITFIELD_H_
+#define BITCONTROL_BITFIELD_H_
+
 #include <ArrayView/ArrayView.h>
 #include <Utilities/CommonTypes.h>
 #include <Utilities/TypeConversion.h>
 
+#include <algorithm>
+#include <array>
+#include <cassert>
 #include <cstdint>
 
+namespace BitFieldWords {
+static const constexpr std::size_t kWordBits = 64;
+static const constexpr std::size_t kByteBits = 8;
+
+inline constexpr uint64_t GetLowMask(const std::size_t count) {
+  return count >= kWordBits ? ~uint64_t{0} : (uint64_t{1} << count) - 1;
+}
+
+/*
+ * Valid bits of the last word of a field of element_count elements
+ * */
+inline constexpr uint64_t GetLastWordMask(const std::size_t element_count) {
+  return element_count % kWordBits ? GetLowMask(element_count % kWordBits)
+                                   : ~uint64_t{0};
+}
+
+/*
+ * Index of the lowest set bit, word must not be 0
+ * */
+inline constexpr std::size_t CountTrailingZeros(const uint64_t word) {
+  assert(word != 0);
+#if defined(__GNUC__)
+  return static_cast<std::size_t>(__builtin_ctzll(word));
+#else
+  std::size_t count = 0;
+  while ((word & (uint64_t{1} << count)) == 0) {
+    count++;
+  }
+  return count;
+#endif
+}
+
+inline constexpr std::size_t PopCount(const uint64_t word) {
+#if defined(__GNUC__)
+  return static_cast<std::size_t>(__builtin_popcountll(word));
+#else
+  std::size_t count = 0;
+  for (uint64_t bits = word; bits; bits &= bits - 1) {
+    count++;
+  }
+  return count;
+#endif
+}
+
+/*
+ * Apply op(word_index, mask) to every word touched by the range
+ * */
+template <typename Operation>
+inline void ForEachWord(const std::size_t start, const std::size_t count,
+                        const Operation &op) {
+  std::size_t position = start;
+  const std::size_t end = start + count;
+  while (position < end) {
+    const std::size_t shift = position % kWordBits;
+    const std::size_t step = std::min(kWordBits - shift, end - position);
+    op(position / kWordBits, GetLowMask(step) << shift);
+    position += step;
+  }
+}
+
+/*
+ * Pack element_count elements from starting_address into bytes LSB first,
+ * padding bits in the last byte are 0. read_range(start, count) returns up
+ * to 64 elements with element start in bit 0.
+ * */
+template <typename ReadRange>
+inline void RangesToBytes(const std::size_t starting_address,
+                          const std::size_t element_count,
+                          const ReadRange &read_range,
+                          ArrayView<uint8_t> *const response_data) {
+  std::size_t byte_number = 0;
+  for (std::size_t offset = 0; offset < element_count; offset += kWordBits) {
+    const std::size_t count =
+        std::min<std::size_t>(kWordBits, element_count - offset);
+    const uint64_t value = read_range(starting_address + offset, count);
+    for (std::size_t shift = 0; shift < count; shift += kByteBits) {
+      response_data->operator[](byte_number++) =
+          static_cast<uint8_t>(0xff & (value >> shift));
+    }
+  }
+}
+
+/*
+ * Inverse of RangesToBytes, write_range(start, count, value) writes the low
+ * count bits of value from element start
+ * */
+template <typename WriteRange>
+inline void BytesToRanges(const std::size_t starting_address,
+                          const std::size_t element_count,
+                          const ArrayView<const uint8_t> data,
+                          const WriteRange &write_range) {
+  assert(data.size() >= Utilities::CalcNumberOfBytesToFitBits(element_count));
+  std::size_t byte_number = 0;
+  for (std::size_t offset = 0; offset < element_count; offset += kWordBits) {
+    const std::size_t count =
+        std::min<std::size_t>(kWordBits, element_count - offset);
+    uint64_t value = 0;
+    for (std::size_t shift = 0; shift < count; shift += kByteBits) {
+      value |= static_cast<uint64_t>(data[byte_number++]) << shift;
+    }
+    write_range(starting_address + offset, count, value);
+  }
+}
+}  //  namespace BitFieldWords
+
 template <std::size_t kElements>
 class BitField {
-  static const std::size_t kByteSize = 8;
-  static const constexpr std::size_t kLog2Of8 = 3;
-  static_assert(1 << kLog2Of8 == 8);
-  // static const constexpr std::size_t kDataBytes = kSize / 8 + 1;
-  static const constexpr std::size_t kByteCount =
-      Utilities::CalcNumberOfBytesToFitBits(kElements);
+  static const constexpr std::size_t kWordBits = BitFieldWords::kWordBits;
+  static const constexpr std::size_t kLog2Of64 = 6;
+  static_assert(1 << kLog2Of64 == kWordBits);
+  static const constexpr std::size_t kWordCount =
+      (kElements + kWordBits - 1) / kWordBits;
+  static const constexpr uint64_t kLastWordMask =
+      BitFieldWords::GetLastWordMask(kElements);
 
-  std::array<uint8_t, kByteCount> data_store_
-      __attribute__((aligned(sizeof(std::size_t))));
+  std::array<uint64_t, kWordCount> data_store_{};
+
+  static constexpr uint64_t GetLowMask(const std::size_t count) {
+    return BitFieldWords::GetLowMask(count);
+  }
+  template <typename Operation>
+  static void ForEachWord(const std::size_t start, const std::size_t count,
+                          const Operation &op) {
+    BitFieldWords::ForEachWord(start, count, op);
+  }
+
+  template <bool kSet>
+  std::size_t FindFirst(const std::size_t start) const {
+    if (start >= kElements) {
+      return kElements;
+    }
+    std::size_t word_index = GetWordIndex(start);
+    uint64_t word = kSet ? data_store_[word_index] : ~data_store_[word_index];
+    word &= ~GetLowMask(GetBitIndex(start));
+    for (;;) {
+      if (word) {
+        return std::min(kElements, word_index * kWordBits +
+                                       BitFieldWords::CountTrailingZeros(word));
+      }
+      if (++word_index == kWordCount) {
+        return kElements;
+      }
+      word = kSet ? data_store_[word_index] : ~data_store_[word_index];
+    }
+  }
 
  public:
   static std::size_t size(void) { return GetSize(); }
   static constexpr std::size_t GetSize(void) { return kElements; }
-  static constexpr std::size_t GetDataArrayIndex(std::size_t address) {
-    return address >> kLog2Of8;
+  static constexpr std::size_t GetWordCount(void) { return kWordCount; }
+  static constexpr std::size_t GetWordIndex(std::size_t address) {
+    return address >> kLog2Of64;
   }
-  static constexpr std::size_t GetDataByteIndex(std::size_t address) {
-    return static_cast<std::size_t>(address & ((1 << kLog2Of8) - 1));
+  static constexpr std::size_t GetBitIndex(std::size_t address) {
+    return address & (kWordBits - 1);
   }
-  static constexpr uint8_t GetByteMask(std::size_t address) {
-    return static_cast<uint8_t>(1 << GetDataByteIndex(address));
+  static constexpr uint64_t GetBitMask(std::size_t address) {
+    return uint64_t{1} << GetBitIndex(address);
   }
   bool ReadElement(uint16_t address) const {
-    return data_store_[GetDataArrayIndex(address)] & GetByteMask(address);
+    return data_store_[GetWordIndex(address)] & GetBitMask(address);
   }
 
   void WriteElement(uint16_t address, bool state) {
     if (state) {
-      data_store_[GetDataArrayIndex(address)] |= (GetByteMask(address));
+      data_store_[GetWordIndex(address)] |= GetBitMask(address);
     } else {
-      data_store_[GetDataArrayIndex(address)] &= ~(GetByteMask(address));
+      data_store_[GetWordIndex(address)] &= ~GetBitMask(address);
+    }
+  }
+
+  /*
+   * Whole storage words for bulk copies, WriteWord drops bits above
+   * kElements
+   * */
+  uint64_t ReadWord(const std::size_t word_index) const {
+    return data_store_[word_index];
+  }
+  void WriteWord(const std::size_t word_index, const uint64_t value) {
+    data_store_[word_index] =
+        word_index + 1 == kWordCount ? value & kLastWordMask : value;
+  }
+
+  /*
+   * Up to 64 elements starting at start, element start in bit 0. Elements
+   * past the end read as 0.
+   * */
+  uint64_t ReadRange(const std::size_t start, const std::size_t count) const {
+    assert(count <= kWordBits);
+    const std::size_t word_index = GetWordIndex(start);
+    if (word_index >= kWordCount || count == 0) {
+      return 0;
+    }
+    const std::size_t shift = GetBitIndex(start);
+    uint64_t value = data_store_[word_index] >> shift;
+    if (shift && word_index + 1 < kWordCount) {
+      value |= data_store_[word_index + 1] << (kWordBits - shift);
     }
+    return value & GetLowMask(count);
+  }
+
+  /*
+   * Write the low count (up to 64) bits of value starting at element start
+   * */
+  void WriteRange(const std::size_t start, const std::size_t count,
+                  const uint64_t value) {
+    assert(count <= kWordBits);
+    assert(start + count <= kElements);
+    //  start may be kElements, one word past the end
+    if (count == 0) {
+      return;
+    }
+    const std::size_t word_index = GetWordIndex(start);
+    const std::size_t shift = GetBitIndex(start);
+    const uint64_t bits = value & GetLowMask(count);
+    const uint64_t low_mask = GetLowMask(count) << shift;
+    data_store_[word_index] =
+        (data_store_[word_index] & ~low_mask) | (bits << shift);
+    if (shift + count > kWordBits) {
+      const uint64_t high_mask = GetLowMask(shift + count - kWordBits);
+      data_store_[word_index + 1] = (data_store_[word_index + 1] & ~high_mask) |
+                                    (bits >> (kWordBits - shift));
+    }
+  }
+
+  void SetRange(const std::size_t start, const std::size_t count) {
+    assert(start + count <= kElements);
+    ForEachWord(start, count, [this](std::size_t word, uint64_t mask) {
+      data_store_[word] |= mask;
+    });
+  }
+
+  void ClearRange(const std::size_t start, const std::size_t count) {
+    assert(start + count <= kElements);
+    ForEachWord(start, count, [this](std::size_t word, uint64_t mask) {
+      data_store_[word] &= ~mask;
+    });
+  }
+
+  /*
+   * Number of set elements in the range, the whole field by default
+   * */
+  std::size_t Count(const std::size_t start = 0,
+                    const std::size_t count = kElements) const {
+    assert(start + count <= kElements);
+    std::size_t total = 0;
+    ForEachWord(start, count, [this, &total](std::size_t word, uint64_t mask) {
+      total += BitFieldWords::PopCount(data_store_[word] & mask);
+    });
+    return total;
   }
+
+  /*
+   * Index of the first set/clear element at or after start, GetSize() if
+   * there is none
+   * */
+  std::size_t FindFirstSet(const std::size_t start = 0) const {
+    return FindFirst<true>(start);
+  }
+  std::size_t FindFirstClear(const std::size_t start = 0) const {
+    return FindFirst<false>(start);
+  }
+
+  /*
+   * Pack element_count elements into bytes LSB first, padding bits in the
+   * last byte are 0
+   * */
   void ReadElementsToBytes(const uint16_t starting_address,
                            const uint16_t element_count,
                            ArrayView<uint8_t> *response_data) const {
-    const std::size_t num_data_bytes =
-        Utilities::CalcNumberOfBytesToFitBits(element_count);
-    std::size_t address = starting_address;
-    for (std::size_t byte_number = 0; byte_number < num_data_bytes;
-         byte_number++) {
-      uint8_t byte_value = 0;
-      for (std::size_t byte_index = 0; byte_index < kByteSize; byte_index++) {
-        const bool state = ReadElement(address++);
-        if (state) {
-          byte_value |= static_cast<uint8_t>(1 << byte_index);
-        }
-      }
-      response_data->operator[](byte_number) = byte_value;
-    }
+    BitFieldWords::RangesToBytes(
+        starting_address, element_count,
+        [this](const std::size_t start, const std::size_t count) {
+          return ReadRange(start, count);
+        },
+        response_data);
   }
+
+  /*
+   * Inverse of ReadElementsToBytes, only element_count elements are written
+   * */
   void WriteMultipleElementsFromBytes(const uint16_t starting_address,
                                       const uint16_t element_count,
                                       const ArrayView<const uint8_t> data) {
-    const std::size_t num_data_bytes =
-        Utilities::CalcNumberOfBytesToFitBits(element_count);
-    assert(data.size() >= num_data_bytes);
-    std::size_t address = starting_address;
-    for (std::size_t byte_number = 0; byte_number < num_data_bytes;
-         byte_number++) {
-      for (std::size_t byte_index = 0; byte_index < kByteSize; byte_index++) {
-        const bool flag_value = (data[byte_number] & (1 << byte_index)) != 0;
-        WriteElement(address++, flag_value);
-      }
-    }
+    BitFieldWords::BytesToRanges(
+        starting_address, element_count, data,
+        [this](const std::size_t start, const std::size_t count,
+               const uint64_t value) { WriteRange(start, count, value); });
   }
 };
+
+#endif  //  BITCONTROL_BITFIELD_H_
@@ -0,0 +1,251 @@
+/*
+ * Copyright 2020 ElectroOptical Innovations, LLC
+ *
+ * Runtime sized counterpart of BitField using the same word layout, for
+ * comparing and merging large alarm and mask sets. The set algebra works on
+ * whole words. Bits above the element count in the last word are kept
+ * clear.
+ * */
+#pragma once
+#ifndef BITCONTROL_DYNAMICBITFIELD_H_
+#define BITCONTROL_DYNAMICBITFIELD_H_
+
+#include <ArrayView/ArrayView.h>
+#include <BitControl/BitField.h>
+#include <Utilities/TypeConversion.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+class DynamicBitField {
+  static const constexpr std::size_t kWordBits = BitFieldWords::kWordBits;
+
+  std::size_t element_count_ = 0;
+  std::vector<uint64_t> data_store_;
+
+  static constexpr std::size_t GetWordsForBits(const std::size_t bits) {
+    return (bits + kWordBits - 1) / kWordBits;
+  }
+
+  void ClearPadding(void) {
+    if (!data_store_.empty()) {
+      data_store_.back() &= BitFieldWords::GetLastWordMask(element_count_);
+    }
+  }
+
+  template <typename Operation>
+  DynamicBitField &Combine(const DynamicBitField &other, const Operation &op) {
+    assert(other.size() == size());
+    const std::size_t words = std::min(GetWordCount(), other.GetWordCount());
+    uint64_t *const out = data_store_.data();
+    const uint64_t *const in = other.data_store_.data();
+    for (std::size_t i = 0; i < words; i++) {
+      out[i] = op(out[i], in[i]);
+    }
+    ClearPadding();
+    return *this;
+  }
+
+ public:
+  std::size_t size(void) const { return element_count_; }
+  std::size_t GetSize(void) const { return element_count_; }
+  std::size_t GetWordCount(void) const { return data_store_.size(); }
+
+  /*
+   * Change the element count, new elements are clear
+   * */
+  void Resize(const std::size_t element_count) {
+    element_count_ = element_count;
+    data_store_.resize(GetWordsForBits(element_count));
+    ClearPadding();
+  }
+
+  bool ReadElement(const std::size_t address) const {
+    assert(address < element_count_);
+    return (data_store_[address / kWordBits] >> (address % kWordBits)) & 1;
+  }
+
+  void WriteElement(const std::size_t address, const bool state) {
+    assert(address < element_count_);
+    const uint64_t mask = uint64_t{1} << (address % kWordBits);
+    uint64_t &word = data_store_[address / kWordBits];
+    word = state ? word | mask : word & ~mask;
+  }
+
+  uint64_t ReadWord(const std::size_t word_index) const {
+    return data_store_[word_index];
+  }
+  void WriteWord(const std::size_t word_index, const uint64_t value) {
+    data_store_[word_index] = value;
+    if (word_index + 1 == GetWordCount()) {
+      ClearPadding();
+    }
+  }
+
+  /*
+   * Up to 64 elements starting at start, element start in bit 0. Elements
+   * past the end read as 0.
+   * */
+  uint64_t ReadRange(const std::size_t start, const std::size_t count) const {
+    assert(count <= kWordBits);
+    const std::size_t word_index = start / kWordBits;
+    if (word_index >= GetWordCount() || count == 0) {
+      return 0;
+    }
+    const std::size_t shift = start % kWordBits;
+    uint64_t value = data_store_[word_index] >> shift;
+    if (shift && word_index + 1 < GetWordCount()) {
+      value |= data_store_[word_index + 1] << (kWordBits - shift);
+    }
+    return value & BitFieldWords::GetLowMask(count);
+  }
+
+  void WriteRange(const std::size_t start, const std::size_t count,
+                  const uint64_t value) {
+    assert(count <= kWordBits);
+    assert(start + count <= element_count_);
+    const uint64_t bits = value & BitFieldWords::GetLowMask(count);
+    BitFieldWords::ForEachWord(
+        start, count, [&](const std::size_t word, const uint64_t mask) {
+          const std::size_t first = std::max(start, word * kWordBits);
+          const uint64_t update = (bits >> (first - start))
+                                  << (first % kWordBits);
+          data_store_[word] = (data_store_[word] & ~mask) | (update & mask);
+        });
+  }
+
+  void SetRange(const std::size_t start, const std::size_t count) {
+    assert(start + count <= element_count_);
+    BitFieldWords::ForEachWord(
+        start, count, [this](const std::size_t word, const uint64_t mask) {
+          data_store_[word] |= mask;
+        });
+  }
+
+  void ClearRange(const std::size_t start, const std::size_t count) {
+    assert(start + count <= element_count_);
+    BitFieldWords::ForEachWord(
+        start, count, [this](const std::size_t word, const uint64_t mask) {
+          data_store_[word] &= ~mask;
+        });
+  }
+
+  void Reset(void) { std::fill(data_store_.begin(), data_store_.end(), 0); }
+
+  /*
+   * Set algebra with a field of the same size, the result replaces this
+   * field
+   * */
+  DynamicBitField &And(const DynamicBitField &other) {
+    return Combine(other, [](uint64_t a, uint64_t b) { return a & b; });
+  }
+  DynamicBitField &Or(const DynamicBitField &other) {
+    return Combine(other, [](uint64_t a, uint64_t b) { return a | b; });
+  }
+  DynamicBitField &Xor(const DynamicBitField &other) {
+    return Combine(other, [](uint64_t a, uint64_t b) { return a ^ b; });
+  }
+  DynamicBitField &AndNot(const DynamicBitField &other) {
+    return Combine(other, [](uint64_t a, uint64_t b) { return a & ~b; });
+  }
+  DynamicBitField &Invert(void) {
+    for (auto &word : data_store_) {
+      word = ~word;
+    }
+    ClearPadding();
+    return *this;
+  }
+
+  std::size_t Count(void) const {
+    std::size_t total = 0;
+    for (const uint64_t word : data_store_) {
+      total += BitFieldWords::PopCount(word);
+    }
+    return total;
+  }
+
+  bool Any(void) const {
+    return std::any_of(data_store_.begin(), data_store_.end(),
+                       [](uint64_t word) { return word != 0; });
+  }
+
+  /*
+   * Index of the first set element at or after start, size() if none
+   * */
+  std::size_t FindFirstSet(const std::size_t start = 0) const {
+    if (start >= element_count_) {
+      return element_count_;
+    }
+    std::size_t word_index = start / kWordBits;
+    uint64_t word = data_store_[word_index] &
+                    ~BitFieldWords::GetLowMask(start % kWordBits);
+    while (word == 0) {
+      if (++word_index == GetWordCount()) {
+        return element_count_;
+      }
+      word = data_store_[word_index];
+    }
+    return word_index * kWordBits + BitFieldWords::CountTrailingZeros(word);
+  }
+
+  /*
+   * Call visit(index) for every set element in increasing order
+   * */
+  template <typename Visitor>
+  void ForEachSet(const Visitor &visit) const {
+    for (std::size_t word_index = 0; word_index < GetWordCount();
+         word_index++) {
+      for (uint64_t word = data_store_[word_index]; word; word &= word - 1) {
+        visit(word_index * kWordBits + BitFieldWords::CountTrailingZeros(word));
+      }
+    }
+  }
+
+  /*
+   * Serialization in the BitField byte format, LSB first with the padding
+   * bits of the last byte clear
+   * */
+  void ReadElementsToBytes(const std::size_t starting_address,
+                           const std::size_t element_count,
+                           ArrayView<uint8_t> *response_data) const {
+    BitFieldWords::RangesToBytes(
+        starting_address, element_count,
+        [this](const std::size_t start, const std::size_t count) {
+          return ReadRange(start, count);
+        },
+        response_data);
+  }
+
+  void WriteMultipleElementsFromBytes(const std::size_t starting_address,
+                                      const std::size_t element_count,
+                                      const ArrayView<const uint8_t> data) {
+    BitFieldWords::BytesToRanges(
+        starting_address, element_count, data,
+        [this](const std::size_t start, const std::size_t count,
+               const uint64_t value) { WriteRange(start, count, value); });
+  }
+
+  template <std::size_t kElements>
+  void CopyTo(BitField<kElements> *const out) const {
+    assert(kElements == element_count_);
+    for (std::size_t word = 0; word < out->GetWordCount(); word++) {
+      out->WriteWord(word, word < GetWordCount() ? data_store_[word] : 0);
+    }
+  }
+
+  DynamicBitField(void) {}
+  explicit DynamicBitField(const std::size_t element_count) {
+    Resize(element_count);
+  }
+  template <std::size_t kElements>
+  explicit DynamicBitField(const BitField<kElements> &field) {
+    Resize(kElements);
+    for (std::size_t word = 0; word < GetWordCount(); word++) {
+      data_store_[word] = field.ReadWord(word);
+    }
+  }
+};
+
+#endif  //  BITCONTROL_DYNAMICBITFIELD_H_
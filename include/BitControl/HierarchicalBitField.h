@@ -0,0 +1,238 @@
+/*
+ * Copyright 2020 ElectroOptical Innovations, LLC
+ *
+ * BitField with summary levels for fast searches of large occupancy maps.
+ * Above the element words each summary level holds one bit per word of the
+ * level below, in two flavours: "any set" (the word is non zero) and "not
+ * full" (the word has a clear element). Finding the first set or clear
+ * element walks up until a word has a candidate then down with one ctz per
+ * level, so a million elements take four levels. Writes update the
+ * summaries bottom up and stop as soon as a summary bit is unchanged.
+ * */
+#pragma once
+#ifndef BITCONTROL_HIERARCHICALBITFIELD_H_
+#define BITCONTROL_HIERARCHICALBITFIELD_H_
+
+#include <BitControl/BitField.h>
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+
+template <std::size_t kElements>
+class HierarchicalBitField {
+  static const constexpr std::size_t kWordBits = BitFieldWords::kWordBits;
+
+  static constexpr std::size_t GetWordsForBits(const std::size_t bits) {
+    return (bits + kWordBits - 1) / kWordBits;
+  }
+
+  //  summary levels until a level fits in one word
+  static constexpr std::size_t CalcLevelCount(void) {
+    std::size_t levels = 0;
+    for (std::size_t words = GetWordsForBits(kElements); words > 1;
+         words = GetWordsForBits(words)) {
+      levels++;
+    }
+    return levels;
+  }
+
+  static const constexpr std::size_t kSummaryLevels = CalcLevelCount();
+
+  //  level 0 is the element words, level n > 0 has one bit per word of n - 1
+  static constexpr std::size_t GetLevelBits(const std::size_t level) {
+    std::size_t bits = kElements;
+    for (std::size_t i = 0; i < level; i++) {
+      bits = GetWordsForBits(bits);
+    }
+    return bits;
+  }
+
+  //  offset of summary level n (n >= 1) in the summary word arrays
+  static constexpr std::size_t GetLevelOffset(const std::size_t level) {
+    std::size_t offset = 0;
+    for (std::size_t i = 1; i < level; i++) {
+      offset += GetWordsForBits(GetLevelBits(i));
+    }
+    return offset;
+  }
+
+  static const constexpr std::size_t kSummaryWords =
+      GetLevelOffset(kSummaryLevels + 1);
+
+  using Summary = std::array<uint64_t, (kSummaryWords ? kSummaryWords : 1)>;
+
+  BitField<kElements> elements_{};
+  Summary any_set_{};
+  Summary not_full_{};
+
+  static uint64_t GetElementMask(const std::size_t word) {
+    return word + 1 == GetWordsForBits(kElements)
+               ? BitFieldWords::GetLastWordMask(kElements)
+               : ~uint64_t{0};
+  }
+
+  //  candidate bits of a word, set elements or clear elements
+  template <bool kSet>
+  uint64_t GetCandidates(const std::size_t level,
+                         const std::size_t word) const {
+    if (level == 0) {
+      const uint64_t value = elements_.ReadWord(word);
+      return kSet ? value : ~value & GetElementMask(word);
+    }
+    const std::size_t index = GetLevelOffset(level) + word;
+    return kSet ? any_set_[index] : not_full_[index];
+  }
+
+  static void WriteSummaryBit(Summary *const summary, const std::size_t level,
+                              const std::size_t bit, const bool state) {
+    uint64_t &word = (*summary)[GetLevelOffset(level) + bit / kWordBits];
+    const uint64_t mask = uint64_t{1} << (bit % kWordBits);
+    word = state ? word | mask : word & ~mask;
+  }
+
+  /*
+   * Propagate a change of element word word upward
+   * */
+  void UpdateSummaries(std::size_t word) {
+    const uint64_t value = elements_.ReadWord(word);
+    bool any_set = value != 0;
+    bool not_full = value != GetElementMask(word);
+    bool any_changed = true;
+    bool not_full_changed = true;
+    for (std::size_t level = 1; level <= kSummaryLevels; level++) {
+      const std::size_t index = GetLevelOffset(level) + word / kWordBits;
+      const uint64_t any_before = any_set_[index];
+      const uint64_t not_full_before = not_full_[index];
+      if (any_changed) {
+        WriteSummaryBit(&any_set_, level, word, any_set);
+      }
+      if (not_full_changed) {
+        WriteSummaryBit(&not_full_, level, word, not_full);
+      }
+      //  the next level only changes if this word became or stopped being 0
+      any_changed = (any_before != 0) != (any_set_[index] != 0);
+      not_full_changed = (not_full_before != 0) != (not_full_[index] != 0);
+      if (!any_changed && !not_full_changed) {
+        return;
+      }
+      any_set = any_set_[index] != 0;
+      not_full = not_full_[index] != 0;
+      word /= kWordBits;
+    }
+  }
+
+  template <bool kSet>
+  std::size_t FindFirst(const std::size_t start) const {
+    if (start >= kElements) {
+      return kElements;
+    }
+    //  climb until a word at or after the position has a candidate
+    std::size_t level = 0;
+    std::size_t position = start;
+    uint64_t candidates = 0;
+    for (;;) {
+      const std::size_t word = position / kWordBits;
+      candidates = GetCandidates<kSet>(level, word) &
+                   ~BitFieldWords::GetLowMask(position % kWordBits);
+      if (candidates) {
+        position =
+            word * kWordBits + BitFieldWords::CountTrailingZeros(candidates);
+        break;
+      }
+      if (level == kSummaryLevels) {
+        return kElements;
+      }
+      position = word + 1;
+      level++;
+      if (position >= GetLevelBits(level)) {
+        return kElements;
+      }
+    }
+    //  descend taking the first candidate of each word
+    while (level > 0) {
+      level--;
+      position = position * kWordBits +
+                 BitFieldWords::CountTrailingZeros(
+                     GetCandidates<kSet>(level, position));
+    }
+    return position;
+  }
+
+ public:
+  static constexpr std::size_t GetSize(void) { return kElements; }
+  static constexpr std::size_t size(void) { return GetSize(); }
+  static constexpr std::size_t GetSummaryLevels(void) {
+    return kSummaryLevels;
+  }
+
+  bool ReadElement(const std::size_t address) const {
+    return (elements_.ReadWord(address / kWordBits) >> (address % kWordBits)) &
+           1;
+  }
+
+  void WriteElement(const std::size_t address, const bool state) {
+    assert(address < kElements);
+    const std::size_t word = address / kWordBits;
+    const uint64_t mask = uint64_t{1} << (address % kWordBits);
+    const uint64_t before = elements_.ReadWord(word);
+    const uint64_t after = state ? before | mask : before & ~mask;
+    if (after != before) {
+      elements_.WriteWord(word, after);
+      UpdateSummaries(word);
+    }
+  }
+
+  void SetRange(const std::size_t start, const std::size_t count) {
+    elements_.SetRange(start, count);
+    BitFieldWords::ForEachWord(
+        start, count,
+        [this](const std::size_t word, uint64_t) { UpdateSummaries(word); });
+  }
+
+  void ClearRange(const std::size_t start, const std::size_t count) {
+    elements_.ClearRange(start, count);
+    BitFieldWords::ForEachWord(
+        start, count,
+        [this](const std::size_t word, uint64_t) { UpdateSummaries(word); });
+  }
+
+  std::size_t Count(void) const { return elements_.Count(); }
+
+  /*
+   * Index of the first set/clear element at or after start, GetSize() if
+   * there is none
+   * */
+  std::size_t FindFirstSet(const std::size_t start = 0) const {
+    return FindFirst<true>(start);
+  }
+  std::size_t FindFirstClear(const std::size_t start = 0) const {
+    return FindFirst<false>(start);
+  }
+
+  /*
+   * Claim the first clear element for a slot pool, GetSize() when full
+   * */
+  std::size_t Acquire(void) {
+    const std::size_t slot = FindFirstClear();
+    if (slot < kElements) {
+      WriteElement(slot, true);
+    }
+    return slot;
+  }
+
+  const BitField<kElements> &GetElements(void) const { return elements_; }
+
+  void Reset(void) {
+    elements_ = BitField<kElements>{};
+    any_set_ = Summary{};
+    not_full_ = Summary{};
+    for (std::size_t word = 0; word < GetWordsForBits(kElements); word++) {
+      UpdateSummaries(word);
+    }
+  }
+
+  HierarchicalBitField(void) { Reset(); }
+};
+
+#endif  //  BITCONTROL_HIERARCHICALBITFIELD_H_
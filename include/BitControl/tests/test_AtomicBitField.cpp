@@ -0,0 +1,80 @@
+/*
+ * Copyright 2020 Electrooptical Innovations
+ * */
+#include <BitControl/AtomicBitField.h>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace Tests {
+TEST(AtomicBitField, ConcurrentWriters) {
+  static const constexpr std::size_t kSize = 200;
+  static const constexpr std::size_t kThreads = 4;
+  AtomicBitField<kSize> flags;
+  std::vector<std::thread> threads;
+  //  interleaved elements so every thread hits every word
+  for (std::size_t thread = 0; thread < kThreads; thread++) {
+    threads.emplace_back([&flags, thread]() {
+      for (int repeat = 0; repeat < 200; repeat++) {
+        for (std::size_t i = thread; i < kSize; i += kThreads) {
+          flags.WriteElement(static_cast<uint16_t>(i), repeat % 2 == 0);
+        }
+      }
+      for (std::size_t i = thread; i < kSize; i += kThreads) {
+        flags.WriteElement(static_cast<uint16_t>(i), true);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(kSize, flags.snapshot().Count());
+}
+
+TEST(AtomicBitField, TestAndSetClaimsOnce) {
+  static const constexpr std::size_t kSize = 128;
+  AtomicBitField<kSize> flags;
+  std::array<std::atomic<int>, kSize> claims{};
+  std::vector<std::thread> threads;
+  for (int thread = 0; thread < 4; thread++) {
+    threads.emplace_back([&flags, &claims]() {
+      for (uint16_t i = 0; i < kSize; i++) {
+        if (!flags.test_and_set(i)) {
+          claims[i]++;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (const auto &claim : claims) {
+    EXPECT_EQ(1, claim.load());
+  }
+}
+
+TEST(AtomicBitField, Ranges) {
+  AtomicBitField<150> flags;
+  EXPECT_EQ(0, flags.fetch_or(60, 10, 0x3ff));
+  EXPECT_EQ(0x3ff, flags.fetch_or(60, 10, 0));
+  EXPECT_EQ(0x3ff, flags.fetch_or(55, 20, 0x1) >> 5);
+  EXPECT_TRUE(flags.ReadElement(55));
+  EXPECT_FALSE(flags.test_and_clear(56));
+  EXPECT_TRUE(flags.test_and_clear(55));
+
+  flags.SetRange(100, 50);
+  flags.ClearRange(120, 4);
+  auto snapshot = flags.snapshot();
+  EXPECT_EQ(10 + 46, snapshot.Count());
+  EXPECT_EQ(120, snapshot.FindFirstClear(100));
+  EXPECT_EQ(0x3ff, snapshot.ReadRange(60, 10));
+
+  const auto drained = flags.exchange_clear();
+  EXPECT_EQ(10 + 46, drained.Count());
+  EXPECT_EQ(0, flags.snapshot().Count());
+}
+}  // namespace Tests
@@ -15,7 +15,9 @@
 #include <array>
 #include <cassert>
 #include <cstdint>
+#include <algorithm>
 #include <iostream>
+#include <random>
 #include <vector>
 
 #include "../BitField.h"
@@ -26,7 +28,7 @@ struct CoilDataFixture : public ::testing::Test {
   BitField<kCoilCount> dc{};
 };
 TEST_F(CoilDataFixture, BitFieldRead) {
-  for (std::size_t address = 0; address < dc.size(); address++) {
+  for (uint16_t address = 0; address < dc.size(); address++) {
     dc.WriteElement(address, true);
     EXPECT_TRUE(dc.ReadElement(address) == true);
     dc.WriteElement(address, false);
@@ -34,17 +36,17 @@ TEST_F(CoilDataFixture, BitFieldRead) {
     dc.WriteElement(address, true);
     EXPECT_TRUE(dc.ReadElement(address) == true);
   }
-  for (std::size_t index = 0; index < dc.size(); index++) {
+  for (uint16_t index = 0; index < dc.size(); index++) {
     EXPECT_TRUE(dc.ReadElement(index) == true);
   }
-  EXPECT_TRUE(dc.ReadElement(kCoilCount - 1) == true);
+  EXPECT_TRUE(dc.ReadElement(static_cast<uint16_t>(kCoilCount - 1)) == true);
 }
 
 TEST_F(CoilDataFixture, BitFieldWriteSingleBit) {
-  for (std::size_t index = 0; index < dc.size(); index++) {
+  for (uint16_t index = 0; index < dc.size(); index++) {
     dc.WriteElement(index, true);
     EXPECT_TRUE(dc.ReadElement(index) == true);
-    for (std::size_t sub_address = 0; sub_address < dc.size(); sub_address++) {
+    for (uint16_t sub_address = 0; sub_address < dc.size(); sub_address++) {
       if (sub_address == index) {
         EXPECT_TRUE(dc.ReadElement(sub_address) == true);
       } else {
@@ -56,6 +58,130 @@ TEST_F(CoilDataFixture, BitFieldWriteSingleBit) {
   }
 }
 
+namespace {
+//  byte per element reference model
+template <std::size_t kSize>
+struct ReferenceField {
+  BitField<kSize> field{};
+  std::vector<bool> model = std::vector<bool>(kSize);
+
+  void Randomize(std::mt19937 *generator) {
+    for (std::size_t i = 0; i < kSize; i++) {
+      model[i] = ((*generator)() & 1) != 0;
+      field.WriteElement(static_cast<uint16_t>(i), model[i]);
+    }
+  }
+  void Check(void) const {
+    for (std::size_t i = 0; i < kSize; i++) {
+      ASSERT_EQ(model[i], field.ReadElement(static_cast<uint16_t>(i))) << i;
+    }
+  }
+};
+}  // namespace
+
+TEST(BitField, ReadWriteBytes) {
+  static const constexpr std::size_t kSize = 2000;
+  std::mt19937 generator{1};
+  ReferenceField<kSize> ref;
+  ref.Randomize(&generator);
+  const std::array<std::pair<uint16_t, uint16_t>, 6> ranges{{
+      {0, 1}, {3, 13}, {60, 70}, {127, 1500}, {1990, 10}, {0, kSize}}};
+  for (const auto &range : ranges) {
+    const uint16_t start = range.first;
+    const uint16_t count = range.second;
+    std::vector<uint8_t> bytes(Utilities::CalcNumberOfBytesToFitBits(count));
+    ArrayView<uint8_t> view{bytes.size(), bytes.data()};
+    ref.field.ReadElementsToBytes(start, count, &view);
+    for (std::size_t i = 0; i < bytes.size() * 8; i++) {
+      const bool expected = i < count ? bool(ref.model[start + i]) : false;
+      EXPECT_EQ(expected, ((bytes[i / 8] >> (i % 8)) & 1) != 0) << i;
+    }
+
+    for (auto &byte : bytes) {
+      byte = static_cast<uint8_t>(generator());
+    }
+    ref.field.WriteMultipleElementsFromBytes(
+        start, count, ArrayView<const uint8_t>{bytes.size(), bytes.data()});
+    for (std::size_t i = 0; i < count; i++) {
+      ref.model[start + i] = ((bytes[i / 8] >> (i % 8)) & 1) != 0;
+    }
+    ref.Check();
+  }
+}
+
+TEST(BitField, Ranges) {
+  static const constexpr std::size_t kSize = 300;
+  std::mt19937 generator{2};
+  ReferenceField<kSize> ref;
+  ref.Randomize(&generator);
+  for (int trial = 0; trial < 500; trial++) {
+    const std::size_t start = generator() % kSize;
+    const std::size_t count = generator() % (kSize - start + 1);
+    const bool set = generator() & 1;
+    if (set) {
+      ref.field.SetRange(start, count);
+    } else {
+      ref.field.ClearRange(start, count);
+    }
+    for (std::size_t i = start; i < start + count; i++) {
+      ref.model[i] = set;
+    }
+    ref.Check();
+    const auto first = ref.model.begin() + static_cast<std::ptrdiff_t>(start);
+    const auto expected = static_cast<std::size_t>(
+        std::count(first, first + static_cast<std::ptrdiff_t>(count), true));
+    EXPECT_EQ(expected, ref.field.Count(start, count));
+  }
+
+  for (int trial = 0; trial < 500; trial++) {
+    const std::size_t start = generator() % (kSize - 1);
+    const std::size_t count = std::min<std::size_t>(64, kSize - start);
+    const uint64_t value = (uint64_t{generator()} << 32) | generator();
+    ref.field.WriteRange(start, count, value);
+    for (std::size_t i = 0; i < count; i++) {
+      ref.model[start + i] = ((value >> i) & 1) != 0;
+    }
+    ref.Check();
+    EXPECT_EQ(count == 64 ? value : value & ((uint64_t{1} << count) - 1),
+              ref.field.ReadRange(start, count));
+  }
+}
+
+static_assert(BitFieldWords::CountTrailingZeros(uint64_t{1} << 63) == 63);
+static_assert(BitFieldWords::CountTrailingZeros(0x80) == 7);
+static_assert(BitFieldWords::PopCount(0) == 0);
+static_assert(BitFieldWords::PopCount(~uint64_t{0}) == 64);
+
+TEST(BitField, EmptyRangeAtTheEnd) {
+  //  a whole number of words, the end is the start of a word past the store
+  BitField<128> field{};
+  field.SetRange(0, 128);
+  field.WriteRange(128, 0, 0);
+  EXPECT_EQ(0u, field.ReadRange(128, 0));
+  EXPECT_EQ(128u, field.Count());
+}
+
+TEST(BitField, FindFirst) {
+  BitField<130> field{};
+  EXPECT_EQ(130, field.FindFirstSet());
+  EXPECT_EQ(0, field.FindFirstClear());
+  field.SetRange(0, 130);
+  EXPECT_EQ(130, field.Count());
+  EXPECT_EQ(130, field.FindFirstClear());
+  field.WriteElement(129, false);
+  EXPECT_EQ(129, field.FindFirstClear());
+  field.ClearRange(0, 100);
+  EXPECT_EQ(100, field.FindFirstSet());
+  EXPECT_EQ(101, field.FindFirstSet(101));
+  EXPECT_EQ(130, field.FindFirstSet(129));
+  EXPECT_EQ(64, field.FindFirstClear(64));
+  EXPECT_EQ(129, field.FindFirstClear(100));
+  //  padding bits of the last word are never set
+  field.WriteWord(field.GetWordCount() - 1, ~uint64_t{0});
+  EXPECT_EQ(30, field.Count(64, 66));
+  EXPECT_EQ(130, field.FindFirstClear(100));
+}
+
 #if 0
 TEST(ModbusCoils, WriteMultipleCoilsResponse) {
   Modbus::Response response;
@@ -0,0 +1,136 @@
+/*
+ * Copyright 2020 Electrooptical Innovations
+ * */
+#include <BitControl/DynamicBitField.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace Tests {
+namespace {
+DynamicBitField MakeRandom(const std::size_t size, std::vector<bool> *model,
+                           std::mt19937 *generator) {
+  DynamicBitField field{size};
+  model->assign(size, false);
+  for (std::size_t i = 0; i < size; i++) {
+    (*model)[i] = ((*generator)() & 3) == 0;
+    field.WriteElement(i, (*model)[i]);
+  }
+  return field;
+}
+
+void Check(const DynamicBitField &field, const std::vector<bool> &model) {
+  ASSERT_EQ(model.size(), field.size());
+  std::size_t count = 0;
+  for (std::size_t i = 0; i < model.size(); i++) {
+    ASSERT_EQ(model[i], field.ReadElement(i)) << i;
+    count += model[i];
+  }
+  EXPECT_EQ(count, field.Count());
+}
+}  // namespace
+
+TEST(DynamicBitField, SetAlgebra) {
+  std::mt19937 generator{11};
+  for (const std::size_t size : {1, 63, 64, 65, 1000, 4099}) {
+    std::vector<bool> a_model;
+    std::vector<bool> b_model;
+    const auto a = MakeRandom(size, &a_model, &generator);
+    const auto b = MakeRandom(size, &b_model, &generator);
+
+    std::vector<bool> expected(size);
+    auto result = a;
+    result.And(b);
+    for (std::size_t i = 0; i < size; i++) {
+      expected[i] = a_model[i] && b_model[i];
+    }
+    Check(result, expected);
+
+    result = a;
+    result.Or(b);
+    for (std::size_t i = 0; i < size; i++) {
+      expected[i] = a_model[i] || b_model[i];
+    }
+    Check(result, expected);
+
+    result = a;
+    result.Xor(b);
+    for (std::size_t i = 0; i < size; i++) {
+      expected[i] = a_model[i] != b_model[i];
+    }
+    Check(result, expected);
+
+    result = a;
+    result.AndNot(b);
+    for (std::size_t i = 0; i < size; i++) {
+      expected[i] = a_model[i] && !b_model[i];
+    }
+    Check(result, expected);
+
+    result = a;
+    result.Invert();
+    for (std::size_t i = 0; i < size; i++) {
+      expected[i] = !a_model[i];
+    }
+    Check(result, expected);
+  }
+}
+
+TEST(DynamicBitField, Iteration) {
+  std::mt19937 generator{12};
+  std::vector<bool> model;
+  const auto field = MakeRandom(777, &model, &generator);
+  std::vector<std::size_t> expected;
+  for (std::size_t i = 0; i < model.size(); i++) {
+    if (model[i]) {
+      expected.push_back(i);
+    }
+  }
+  std::vector<std::size_t> visited;
+  field.ForEachSet([&visited](std::size_t index) { visited.push_back(index); });
+  EXPECT_EQ(expected, visited);
+
+  visited.clear();
+  for (std::size_t i = field.FindFirstSet(); i < field.size();
+       i = field.FindFirstSet(i + 1)) {
+    visited.push_back(i);
+  }
+  EXPECT_EQ(expected, visited);
+}
+
+TEST(DynamicBitField, Conversions) {
+  BitField<150> fixed{};
+  fixed.SetRange(10, 70);
+  fixed.WriteElement(149, true);
+  DynamicBitField dynamic{fixed};
+  EXPECT_EQ(150, dynamic.size());
+  EXPECT_EQ(71, dynamic.Count());
+  dynamic.ClearRange(20, 5);
+
+  BitField<150> copy{};
+  dynamic.CopyTo(&copy);
+  EXPECT_EQ(66, copy.Count());
+  EXPECT_EQ(20, copy.FindFirstClear(10));
+
+  std::vector<uint8_t> bytes(19);
+  ArrayView<uint8_t> view{bytes.size(), bytes.data()};
+  dynamic.ReadElementsToBytes(0, 150, &view);
+  std::vector<uint8_t> fixed_bytes(19);
+  ArrayView<uint8_t> fixed_view{fixed_bytes.size(), fixed_bytes.data()};
+  copy.ReadElementsToBytes(0, 150, &fixed_view);
+  EXPECT_EQ(fixed_bytes, bytes);
+
+  DynamicBitField restored{150};
+  restored.WriteMultipleElementsFromBytes(
+      0, 150, ArrayView<const uint8_t>{bytes.size(), bytes.data()});
+  restored.Xor(dynamic);
+  EXPECT_FALSE(restored.Any());
+
+  dynamic.Resize(300);
+  EXPECT_EQ(66, dynamic.Count());
+  dynamic.Resize(100);
+  EXPECT_EQ(65, dynamic.Count());
+}
+}  // namespace Tests
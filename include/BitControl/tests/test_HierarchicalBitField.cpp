@@ -0,0 +1,92 @@
+/*
+ * Copyright 2020 Electrooptical Innovations
+ * */
+#include <BitControl/HierarchicalBitField.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace Tests {
+namespace {
+template <typename Field>
+void CheckSearches(const Field &field, const std::vector<bool> &model,
+                   const std::size_t start) {
+  std::size_t set = start;
+  while (set < model.size() && !model[set]) {
+    set++;
+  }
+  std::size_t clear = start;
+  while (clear < model.size() && model[clear]) {
+    clear++;
+  }
+  EXPECT_EQ(set, field.FindFirstSet(start)) << start;
+  EXPECT_EQ(clear, field.FindFirstClear(start)) << start;
+}
+
+template <std::size_t kSize>
+void RandomWrites(const unsigned seed, const int trials) {
+  auto field = std::make_unique<HierarchicalBitField<kSize>>();
+  std::vector<bool> model(kSize);
+  std::mt19937 generator{seed};
+  CheckSearches(*field, model, 0);
+  for (int trial = 0; trial < trials; trial++) {
+    //  sparse early, mostly full later so both searches travel far
+    const bool state = (generator() % 100) <
+                       static_cast<unsigned>(100 * trial / trials);
+    if (generator() % 8 == 0) {
+      const std::size_t start = generator() % kSize;
+      const std::size_t count =
+          std::min<std::size_t>(generator() % 300, kSize - start);
+      if (state) {
+        field->SetRange(start, count);
+      } else {
+        field->ClearRange(start, count);
+      }
+      for (std::size_t i = start; i < start + count; i++) {
+        model[i] = state;
+      }
+    } else {
+      const std::size_t address = generator() % kSize;
+      field->WriteElement(address, state);
+      model[address] = state;
+    }
+    CheckSearches(*field, model, 0);
+    CheckSearches(*field, model, generator() % kSize);
+  }
+}
+}  // namespace
+
+TEST(HierarchicalBitField, Levels) {
+  EXPECT_EQ(0, HierarchicalBitField<64>::GetSummaryLevels());
+  EXPECT_EQ(1, HierarchicalBitField<65>::GetSummaryLevels());
+  EXPECT_EQ(2, HierarchicalBitField<64 * 64 + 1>::GetSummaryLevels());
+  EXPECT_EQ(3, HierarchicalBitField<1000000>::GetSummaryLevels());
+}
+
+TEST(HierarchicalBitField, MatchesLinearScan) {
+  RandomWrites<50>(1, 2000);
+  RandomWrites<130>(2, 2000);
+  RandomWrites<4097>(3, 2000);
+  RandomWrites<300000>(4, 100);
+}
+
+TEST(HierarchicalBitField, Acquire) {
+  auto pool = std::make_unique<HierarchicalBitField<1000000>>();
+  pool->SetRange(0, 999990);
+  pool->WriteElement(12345, false);
+  EXPECT_EQ(12345, pool->Acquire());
+  for (std::size_t slot = 999990; slot < 1000000; slot++) {
+    EXPECT_EQ(slot, pool->Acquire());
+  }
+  EXPECT_EQ(1000000, pool->Acquire());
+  EXPECT_EQ(1000000, pool->Count());
+  pool->WriteElement(777, false);
+  EXPECT_EQ(777, pool->FindFirstClear());
+  pool->ClearRange(0, 1000000);
+  EXPECT_EQ(1000000, pool->FindFirstSet());
+  EXPECT_EQ(0, pool->Count());
+}
+}  // namespace Tests
@@ -5,11 +5,13 @@
 #pragma once
 #ifndef CALCULATORS_CALCULATORBASE_H_
 #define CALCULATORS_CALCULATORBASE_H_
+#include <Utilities/InvariantDivisor.h>
 #include <Utilities/TypeConversion.h>
 #include <Utilities/math.h>
 
 #include <cassert>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <limits>
 #include <tuple>
@@ -64,8 +66,10 @@ MultiplyShiftEstimate(const double value, const std::size_t multiplier_max,
       last_diff = diff;
     }
   }
-  const auto error = last_diff;
-  const auto cast_error = Utilities::StaticCastQuickFail<T>(error);
+  //  round and range check the micro error before narrowing it
+  const double error = Utilities::round(last_diff);
+  assert(error <= static_cast<double>(std::numeric_limits<T>::max()));
+  const T cast_error = static_cast<T>(error);
   if (value != abs_value) {
     mult *= -1;
   }
@@ -183,6 +187,67 @@ namespace Calculator {
     return Utilities::StaticCastQuickFail<Output>(out);
   }
 
+  /**
+   * ScaleDigitalValue over an array, the range constants are computed once
+   * and the loop is a multiply, add and shift
+   */
+  template <typename Output, typename Input>
+  static void ScaleDigitalValues(const Input *const values,
+                                 const std::size_t count,
+                                 const int bits_of_value,
+                                 const Input scale_low, const Input scale_high,
+                                 Output *const out) {
+    static_assert(std::is_integral_v<Input>, "Input must be integral");
+    static_assert(std::is_integral_v<Output>, "Output must be integral");
+    assert(scale_high > scale_low);
+    assert(bits_of_value > 0);
+    assert(bits_of_value < 63);
+
+    using Wide = int64_t;
+    const Wide w_low = static_cast<Wide>(scale_low);
+    const Wide output_range = static_cast<Wide>(scale_high) - w_low;
+    const Wide half = (Wide{1} << bits_of_value) >> 1;
+    for (std::size_t i = 0; i < count; i++) {
+      const Wide result =
+          ((static_cast<Wide>(values[i]) * output_range) + half) >>
+          bits_of_value;
+      out[i] = static_cast<Output>(result + w_low);
+    }
+  }
+
+  /**
+   * ScaleToDigitalValue over an array. The division by the range is prepared
+   * once as a reciprocal multiply and shift, results are identical to the
+   * single value call.
+   */
+  template <typename Output, typename Input>
+  static void ScaleToDigitalValues(const Input *const values,
+                                   const std::size_t count,
+                                   const int bits_of_output,
+                                   const Input scale_low,
+                                   const Input scale_high, Output *const out) {
+    static_assert(std::is_integral_v<Output>, "Output must be integral");
+    assert(scale_high > scale_low);
+    if (bits_of_output <= 0) {
+      assert(0); //  invalid
+      return;
+    }
+    const auto output_range = scale_high - scale_low;
+    const auto round_off = (output_range + 1) / 2;
+    using Dividend = decltype(((scale_high - scale_low)
+                               << static_cast<Output>(bits_of_output)) +
+                              round_off);
+    const Utilities::InvariantDivisor<Dividend> divisor{
+        static_cast<Dividend>(output_range)};
+    for (std::size_t i = 0; i < count; i++) {
+      assert(values[i] >= scale_low);
+      const auto numerator = (values[i] - scale_low)
+                             << static_cast<Output>(bits_of_output);
+      const auto out_value = divisor.divide(numerator + round_off);
+      out[i] = Utilities::StaticCastQuickFail<Output>(out_value);
+    }
+  }
+
   /**
    * Calculate the potential of one input into a voltage divider given the node
    * value, one potential and both resistors
@@ -0,0 +1,137 @@
+/*
+ * Copyright 2020 ElectroOptical Innovations, LLC
+ *
+ * */
+#pragma once
+#ifndef CALCULATORS_CODETABLE_H_
+#define CALCULATORS_CODETABLE_H_
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+namespace Calculator {
+/**
+ * Conversion of an ADC code by table load. The table is built at compile
+ * time from any constexpr callable taking the code, usually a lambda over
+ * the ScaleDigitalValue, divider and amplifier chain:
+ *
+ * constexpr auto kConvert = [](int32_t code) {
+ *   return Calculator::ScaleDigitalValue<int32_t>(code, 12, 0, 3300000);
+ * };
+ * constexpr Calculator::CodeTable<int32_t, 12> kTable{kConvert};
+ * static_assert(Calculator::GetMaxTableError(kTable, kConvert) == 0);
+ */
+template <typename Output, std::size_t kBits>
+class CodeTable {
+ public:
+  static_assert(kBits > 0 && kBits <= 16,
+                "Tables are for codes of 16 bits or less");
+  static constexpr std::size_t kCodeBits = kBits;
+  static constexpr std::size_t kSize = std::size_t{1} << kBits;
+
+ private:
+  std::array<Output, kSize> table_{};
+
+ public:
+  //  bytes of storage used by the table
+  static constexpr std::size_t GetFootprint(void) {
+    return kSize * sizeof(Output);
+  }
+
+  constexpr Output Convert(const std::size_t code) const {
+    assert(code < kSize);
+    return table_[code];
+  }
+  constexpr Output operator()(const std::size_t code) const {
+    return Convert(code);
+  }
+
+  template <typename Function>
+  explicit constexpr CodeTable(const Function &function) {
+    for (std::size_t code = 0; code < kSize; code++) {
+      table_[code] =
+          static_cast<Output>(function(static_cast<int32_t>(code)));
+    }
+  }
+};
+
+/**
+ * Sparse table with the exact value every 2^(kBits - kKnotBits) codes,
+ * codes in between are linearly interpolated. Suits smooth functions where
+ * the full table would be too large. The function is also evaluated at
+ * 2^kBits to close the last segment.
+ */
+template <typename Output, std::size_t kBits, std::size_t kKnotBits>
+class InterpolatedCodeTable {
+ public:
+  static_assert(kBits > 0 && kBits <= 24,
+                "Tables are for codes of 24 bits or less");
+  static_assert(kKnotBits > 0 && kKnotBits <= kBits,
+                "Knot bits must be between 1 and the code bits");
+  static constexpr std::size_t kCodeBits = kBits;
+  static constexpr std::size_t kSize = std::size_t{1} << kBits;
+  static constexpr std::size_t kShift = kBits - kKnotBits;
+  //  the last knot is at kSize so the final segment has an upper bound
+  static constexpr std::size_t kKnots = (std::size_t{1} << kKnotBits) + 1;
+
+ private:
+  using Wide = int64_t;
+  std::array<Output, kKnots> knots_{};
+
+ public:
+  static constexpr std::size_t GetFootprint(void) {
+    return kKnots * sizeof(Output);
+  }
+
+  constexpr Output Convert(const std::size_t code) const {
+    assert(code < kSize);
+    const std::size_t knot = code >> kShift;
+    const Wide fraction =
+        static_cast<Wide>(code & ((std::size_t{1} << kShift) - 1));
+    const Wide low = static_cast<Wide>(knots_[knot]);
+    const Wide slope = static_cast<Wide>(knots_[knot + 1]) - low;
+    if constexpr (kShift == 0) {
+      return static_cast<Output>(low);
+    } else {
+      //  round to nearest, ties away from zero
+      const Wide product = slope * fraction;
+      const Wide half = Wide{1} << (kShift - 1);
+      const Wide magnitude =
+          ((product < 0 ? -product : product) + half) >> kShift;
+      return static_cast<Output>(low + (product < 0 ? -magnitude : magnitude));
+    }
+  }
+  constexpr Output operator()(const std::size_t code) const {
+    return Convert(code);
+  }
+
+  template <typename Function>
+  explicit constexpr InterpolatedCodeTable(const Function &function) {
+    for (std::size_t knot = 0; knot < kKnots; knot++) {
+      knots_[knot] = static_cast<Output>(
+          function(static_cast<int32_t>(knot << kShift)));
+    }
+  }
+};
+
+/**
+ * Largest absolute difference between the table and the function over
+ * every code, usable in a static_assert
+ */
+template <typename Table, typename Function>
+constexpr int64_t GetMaxTableError(const Table &table,
+                                   const Function &function) {
+  int64_t max_error = 0;
+  for (std::size_t code = 0; code < Table::kSize; code++) {
+    const int64_t exact =
+        static_cast<int64_t>(function(static_cast<int32_t>(code)));
+    const int64_t error = static_cast<int64_t>(table(code)) - exact;
+    const int64_t magnitude = error < 0 ? -error : error;
+    max_error = magnitude > max_error ? magnitude : max_error;
+  }
+  return max_error;
+}
+}  // namespace Calculator
+
+#endif //  CALCULATORS_CODETABLE_H_
@@ -0,0 +1,149 @@
+/*
+ * Copyright 2020 ElectroOptical Innovations, LLC
+ *
+ * */
+#pragma once
+#ifndef CALCULATORS_FIXEDSCALE_H_
+#define CALCULATORS_FIXEDSCALE_H_
+#include <Calculators/CalculatorBase.h>
+#include <Utilities/TypeConversion.h>
+
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <ratio>
+#include <type_traits>
+
+namespace Calculator {
+/**
+ * Multiplication by a constant as an integer multiply and shift. The
+ * constant is a std::ratio as doubles can not be template parameters, the
+ * multiplier and shift come from Utilities::MultiplyShiftEstimate at compile
+ * time and the relative error of the pair is checked against
+ * kMaxErrorPpm (parts per million).
+ *
+ * using InputGain = Calculator::FixedScale<std::ratio<36, 11>>;
+ * const int32_t out = InputGain::apply(in);
+ */
+template <typename Ratio, std::size_t kMultiplierMax = (1 << 16),
+          std::size_t kShiftMax = 16, std::size_t kMaxErrorPpm = 100>
+struct FixedScale {
+  using Wide = int64_t;
+  static constexpr double kValue =
+      static_cast<double>(Ratio::num) / static_cast<double>(Ratio::den);
+
+ private:
+  static constexpr Utilities::MultiplyShiftEstimateResult<Wide> kEstimate =
+      Utilities::MultiplyShiftEstimate<Wide>(kValue, kMultiplierMax,
+                                             kShiftMax);
+
+ public:
+  static constexpr Wide kMultiplier = kEstimate.multiplier;
+  static constexpr int kShift = static_cast<int>(kEstimate.shift);
+  //  absolute error of the multiplier in millionths
+  static constexpr Wide kError = kEstimate.error;
+
+  static_assert(static_cast<double>(kError) <=
+                    static_cast<double>(kMaxErrorPpm) *
+                        Utilities::abs(kValue),
+                "Multiply shift approximation exceeds the error bound, "
+                "increase the multiplier or shift limits");
+
+  /**
+   * x * value rounded to nearest, ties away from zero so the result is
+   * symmetric about 0. The product must fit in 64 bits.
+   */
+  template <typename T>
+  static constexpr T apply(const T x) {
+    static_assert(std::is_integral_v<T>, "Input must be integral");
+    const Wide product = static_cast<Wide>(x) * kMultiplier;
+    if constexpr (kShift == 0) {
+      return static_cast<T>(product);
+    } else {
+      const Wide half = Wide{1} << (kShift - 1);
+      const Wide magnitude =
+          ((product < 0 ? -product : product) + half) >> kShift;
+      return static_cast<T>(product < 0 ? -magnitude : magnitude);
+    }
+  }
+};
+
+template <typename T>
+struct is_fixed_scale : std::false_type {};
+
+template <typename Ratio, std::size_t kMultiplierMax, std::size_t kShiftMax,
+          std::size_t kMaxErrorPpm>
+struct is_fixed_scale<
+    FixedScale<Ratio, kMultiplierMax, kShiftMax, kMaxErrorPpm>>
+    : std::true_type {};
+
+template <typename... Scales>
+constexpr bool are_fixed_scales_v = (is_fixed_scale<Scales>::value && ...);
+
+/**
+ * Division free versions of the calculator functions. The scales are the
+ * resistor ratios the divisions would have computed, for example a two node
+ * divider takes FixedScale<std::ratio<r2, r1 + r2>> for v1 and
+ * FixedScale<std::ratio<r1, r1 + r2>> for v2.
+ */
+template <typename Output, typename Input, typename ScaleV1, typename ScaleV2,
+          typename = std::enable_if_t<are_fixed_scales_v<ScaleV1, ScaleV2>>>
+static constexpr Output TwoNodeVoltageDivider(const Input v1, const Input v2,
+                                              ScaleV1, ScaleV2) {
+  const auto v_node = ScaleV1::apply(v1) + ScaleV2::apply(v2);
+  return Utilities::StaticCastQuickFail<Output>(v_node);
+}
+
+/**
+ * node_scale = (r1 + r2) / r1, v1_scale = r2 / r1
+ */
+template <typename Output, typename Input, typename ScaleNode,
+          typename ScaleV1,
+          typename = std::enable_if_t<are_fixed_scales_v<ScaleNode, ScaleV1>>>
+static constexpr Output TwoNodeVoltageDividerReverse(const Input v1,
+                                                     const Input v_node,
+                                                     ScaleNode, ScaleV1) {
+  const auto Positive = ScaleNode::apply(v_node);
+  const auto Negative = ScaleV1::apply(v1);
+  assert(std::numeric_limits<Input>::is_signed || (Positive >= Negative));
+  return Utilities::StaticCastQuickFail<Output>(Positive - Negative);
+}
+
+/**
+ * Scale of each potential is the product of the other two resistors over
+ * r1 * r2 + r1 * r3 + r2 * r3
+ */
+template <typename Output, typename Input, typename ScaleV1, typename ScaleV2,
+          typename ScaleV3,
+          typename = std::enable_if_t<
+              are_fixed_scales_v<ScaleV1, ScaleV2, ScaleV3>>>
+static constexpr Output ThreeNodeVoltageDivider(const Input v1, const Input v2,
+                                                const Input v3, ScaleV1,
+                                                ScaleV2, ScaleV3) {
+  const auto result =
+      ScaleV1::apply(v1) + ScaleV2::apply(v2) + ScaleV3::apply(v3);
+  return Utilities::StaticCastQuickFail<Output>(result);
+}
+
+/**
+ * gain_scale = fb_resistor / inverting_node_resistor
+ */
+template <typename Output, typename Input, typename ScaleGain,
+          typename = std::enable_if_t<are_fixed_scales_v<ScaleGain>>>
+static constexpr Output AmplifierOutput(const Input noninverting_value,
+                                        const Input inverting_node_value,
+                                        ScaleGain, const Input vhigh,
+                                        const Input vlow = 0) {
+  const auto Negative = ScaleGain::apply(inverting_node_value);
+  const auto Positive =
+      ScaleGain::apply(noninverting_value) + noninverting_value;
+
+  assert(std::numeric_limits<Output>::is_signed || (Positive >= Negative));
+
+  const auto out = Positive - Negative;
+  const auto result = (out > vhigh) ? vhigh : (out < vlow ? vlow : out);
+  return Utilities::StaticCastQuickFail<Output>(result);
+}
+}  // namespace Calculator
+
+#endif //  CALCULATORS_FIXEDSCALE_H_
@@ -0,0 +1,140 @@
+/*
+ * Copyright 2020 ElectroOptical Innovations, LLC
+ *
+ * */
+#pragma once
+#ifndef CALCULATORS_PREPAREDCALCULATOR_H_
+#define CALCULATORS_PREPAREDCALCULATOR_H_
+#include <Calculators/CalculatorBase.h>
+#include <Utilities/InvariantDivisor.h>
+#include <Utilities/TypeConversion.h>
+
+#include <cassert>
+#include <cstdint>
+#include <limits>
+
+/**
+ * Calculator functions for channels whose resistors are only known at
+ * startup (calibration). The constructor does the resistor arithmetic and
+ * prepares each division as an InvariantDivisor, Calculate is then only
+ * multiplies and shifts per sample. Results are identical to the matching
+ * Calculator function called with the same T valued arguments.
+ */
+namespace Calculator {
+template <typename T>
+class PreparedTwoNodeVoltageDivider {
+  T r1_;
+  T r2_;
+  Utilities::InvariantDivisor<T> divisor_;
+
+ public:
+  template <typename Output>
+  constexpr Output Calculate(const T v1, const T v2) const {
+    const T v_node = divisor_.divide(v2 * r1_ + v1 * r2_);
+    return Utilities::StaticCastQuickFail<Output>(v_node);
+  }
+
+  constexpr PreparedTwoNodeVoltageDivider(const T r1, const T r2)
+      : r1_{r1}, r2_{r2}, divisor_{static_cast<T>(r1 + r2)} {}
+};
+
+template <typename T>
+class PreparedTwoNodeVoltageDividerReverse {
+  T sum_;
+  T r2_;
+  Utilities::InvariantDivisor<T> divisor_;
+
+ public:
+  template <typename Output>
+  constexpr Output Calculate(const T v1, const T v_node) const {
+    const T Positive = divisor_.divide(v_node * sum_);
+    const T Negative = divisor_.divide(v1 * r2_);
+    assert(std::numeric_limits<T>::is_signed || (Positive >= Negative));
+    return Utilities::StaticCastQuickFail<Output>(
+        static_cast<T>(Positive - Negative));
+  }
+
+  constexpr PreparedTwoNodeVoltageDividerReverse(const T r1, const T r2)
+      : sum_{static_cast<T>(r1 + r2)}, r2_{r2}, divisor_{r1} {}
+};
+
+template <typename T>
+class PreparedThreeNodeVoltageDivider {
+  T r2_r3_;
+  T r1_r3_;
+  T r1_r2_;
+  Utilities::InvariantDivisor<T> divisor_;
+
+ public:
+  template <typename Output>
+  constexpr Output Calculate(const T v1, const T v2, const T v3) const {
+    const T sum = r2_r3_ * v1 + r1_r3_ * v2 + r1_r2_ * v3;
+    return Utilities::StaticCastQuickFail<Output>(divisor_.divide(sum));
+  }
+
+  constexpr PreparedThreeNodeVoltageDivider(const T r1, const T r2,
+                                            const T r3)
+      : r2_r3_{static_cast<T>(r2 * r3)},
+        r1_r3_{static_cast<T>(r1 * r3)},
+        r1_r2_{static_cast<T>(r1 * r2)},
+        divisor_{static_cast<T>(r1 * r2 + r1 * r3 + r2 * r3)} {}
+};
+
+template <typename T>
+class PreparedThreeNodeVoltageDividerReversed {
+  T divider_;
+  T r3_r2_;
+  T r3_r1_;
+  Utilities::InvariantDivisor<T> divisor_;
+
+ public:
+  template <typename Output>
+  constexpr Output Calculate(const T v1, const T v2, const T node) const {
+    const T sum = node * divider_;
+    //  r3 * (r2 * v1 + r1 * v2) with the products prepared
+    const T numerator_negative = r3_r2_ * v1 + r3_r1_ * v2;
+    assert(std::numeric_limits<Output>::is_signed ||
+           (sum >= numerator_negative));
+    const T result = divisor_.divide(static_cast<T>(sum - numerator_negative));
+    return Utilities::StaticCastQuickFail<Output>(result);
+  }
+
+  constexpr PreparedThreeNodeVoltageDividerReversed(const T r1, const T r2,
+                                                    const T r3)
+      : divider_{static_cast<T>(r1 * (r2 + r3) + r2 * r3)},
+        r3_r2_{static_cast<T>(r3 * r2)},
+        r3_r1_{static_cast<T>(r3 * r1)},
+        divisor_{static_cast<T>(r1 * r2)} {}
+};
+
+template <typename T>
+class PreparedAmplifierOutput {
+  T fb_resistor_;
+  T vhigh_;
+  T vlow_;
+  Utilities::InvariantDivisor<T> divisor_;
+
+ public:
+  template <typename Output>
+  constexpr Output Calculate(const T noninverting_value,
+                             const T inverting_node_value) const {
+    const T Negative = divisor_.divide(inverting_node_value * fb_resistor_);
+    const T Positive =
+        divisor_.divide(noninverting_value * fb_resistor_) + noninverting_value;
+    assert(std::numeric_limits<Output>::is_signed || (Positive >= Negative));
+    const T out = Positive - Negative;
+    const T result = (out > vhigh_) ? vhigh_ : (out < vlow_ ? vlow_ : out);
+    return Utilities::StaticCastQuickFail<Output>(result);
+  }
+
+  constexpr PreparedAmplifierOutput(const T inverting_node_resistor,
+                                    const T fb_resistor, const T vhigh,
+                                    const T vlow = 0)
+      : fb_resistor_{fb_resistor},
+        vhigh_{vhigh},
+        vlow_{vlow},
+        divisor_{inverting_node_resistor} {}
+};
+}  // namespace Calculator
+
+#endif //  CALCULATORS_PREPAREDCALCULATOR_H_
@@ -18,6 +18,7 @@
 #include <cassert>
 #include <cmath>
 #include <cstdint>
+#include <limits>
 
 namespace Utilities {
 const constexpr double kCelsiusOffsetKelvin = 273.15;
@@ -67,6 +68,82 @@ static_assert(TemperatureFromResistance(10000, kBFactorTest, kRInfTest) >=
                   CelsiusToKelvin(24.99),
               "");
 
+/*
+ * Thermistor model 1/T = c0 + c1 ln(R) + ... + cN ln(R)^N with T in kelvin.
+ * Steinhart-Hart is the third order case without the square term and the
+ * Beta model is first order. ln(R) comes from Utilities::Log at kAccuracy
+ * and the polynomial is evaluated with Horner's rule. The kFast log moves
+ * the result by a few microkelvin at most. Resistances must be positive. The
+ * batch version takes all the logs with the Utilities::Log array version
+ * then evaluates the polynomials in place.
+ * */
+template <std::size_t kOrder, MathAccuracy kAccuracy = MathAccuracy::kFast>
+struct LogPolynomialModel {
+  std::array<double, kOrder + 1> coefficients{};  //  c0 first
+
+  constexpr double InverseKelvinFromLog(const double log_resistance) const {
+    double inverse_kelvin = 0;
+    for (std::size_t i = kOrder + 1; i > 0; i--) {
+      inverse_kelvin = inverse_kelvin * log_resistance + coefficients[i - 1];
+    }
+    return inverse_kelvin;
+  }
+
+  double Kelvin(const double resistance) const {
+    assert(resistance >= std::numeric_limits<double>::min());
+    return 1.0 / InverseKelvinFromLog(Utilities::Log<kAccuracy>(resistance));
+  }
+
+  //  unchecked so the loop has no branches
+  void Kelvin(const double* const resistance, const std::size_t count,
+              double* const kelvin) const {
+    Utilities::Log<kAccuracy>(resistance, count, kelvin);
+    for (std::size_t i = 0; i < count; i++) {
+      kelvin[i] = 1.0 / InverseKelvinFromLog(kelvin[i]);
+    }
+  }
+};
+
+template <MathAccuracy kAccuracy = MathAccuracy::kFast>
+using SteinhartHartModel = LogPolynomialModel<3, kAccuracy>;
+
+template <MathAccuracy kAccuracy = MathAccuracy::kFast>
+inline constexpr SteinhartHartModel<kAccuracy> MakeSteinhartHartModel(
+    const double a, const double b, const double c) {
+  return SteinhartHartModel<kAccuracy>{{a, b, 0, c}};
+}
+
+/*
+ * Steinhart-Hart coefficients through three calibration points
+ * */
+template <MathAccuracy kAccuracy = MathAccuracy::kFast>
+inline SteinhartHartModel<kAccuracy> SteinhartHartFromPoints(
+    const double r1, const double kelvin1, const double r2,
+    const double kelvin2, const double r3, const double kelvin3) {
+  const double l1 = Utilities::log(r1);
+  const double l2 = Utilities::log(r2);
+  const double l3 = Utilities::log(r3);
+  const double y1 = 1 / kelvin1;
+  const double gamma2 = (1 / kelvin2 - y1) / (l2 - l1);
+  const double gamma3 = (1 / kelvin3 - y1) / (l3 - l1);
+  const double c = (gamma3 - gamma2) / (l3 - l2) / (l1 + l2 + l3);
+  const double b = gamma2 - c * (l1 * l1 + l1 * l2 + l2 * l2);
+  const double a = y1 - (b + l1 * l1 * c) * l1;
+  return MakeSteinhartHartModel<kAccuracy>(a, b, c);
+}
+
+/*
+ * Beta model as a first order polynomial,
+ * 1/T = 1/T0 - ln(R0) / B + ln(R) / B
+ * */
+template <MathAccuracy kAccuracy = MathAccuracy::kFast>
+inline LogPolynomialModel<1, kAccuracy> MakeBetaModel(
+    const double R0, const double BFactor, const double temp0_celsius) {
+  return LogPolynomialModel<1, kAccuracy>{
+      {1 / CelsiusToKelvin(temp0_celsius) - Utilities::log(R0) / BFactor,
+       1 / BFactor}};
+}
+
 
 }  //  namespace TemperatureCalculator
 }  //  namespace Utilities
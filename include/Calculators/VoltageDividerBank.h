@@ -0,0 +1,104 @@
+/*
+ * Copyright 2020 ElectroOptical Innovations, LLC
+ *
+ * */
+#pragma once
+#ifndef CALCULATORS_VOLTAGEDIVIDERBANK_H_
+#define CALCULATORS_VOLTAGEDIVIDERBANK_H_
+#include <Calculators/CalculatorBase.h>
+#include <Utilities/InvariantDivisor.h>
+#include <Utilities/TypeConversion.h>
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+
+namespace Calculator {
+/**
+ * ThreeNodeVoltageDividerReversed for a bank of channels. Each network is
+ * prepared once with SetChannel, the derived constants are kept as one array
+ * per constant so a sample of every channel is an element wise pass. The
+ * division is done in a second pass with each channel's InvariantDivisor.
+ * Results are identical to
+ * ThreeNodeVoltageDividerReversed<Output>(v1, v2, node, r1, r2, r3).
+ *
+ * Sample blocks are channel fastest, sample s of channel c is at
+ * s * kChannels + c.
+ */
+template <typename T, std::size_t kChannels>
+class ThreeNodeVoltageDividerBank {
+  using Channels = std::array<T, kChannels>;
+
+  Channels divider_{};
+  Channels r3_r2_{};
+  Channels r3_r1_{};
+  std::array<Utilities::InvariantDivisor<T>, kChannels> divisor_{};
+
+  //  node * divider - r3 * (r2 * v1 + r1 * v2) for every channel
+  void CalculateNumerators(const T *const v1, const T *const v2,
+                           const T *const node, Channels *const out) const {
+    for (std::size_t channel = 0; channel < kChannels; channel++) {
+      const T sum = node[channel] * divider_[channel];
+      const T numerator_negative =
+          r3_r2_[channel] * v1[channel] + r3_r1_[channel] * v2[channel];
+      (*out)[channel] = static_cast<T>(sum - numerator_negative);
+    }
+  }
+
+ public:
+  static constexpr std::size_t GetChannelCount(void) { return kChannels; }
+
+  void SetChannel(const std::size_t channel, const T r1, const T r2,
+                  const T r3) {
+    assert(channel < kChannels);
+    divider_[channel] = static_cast<T>(r1 * (r2 + r3) + r2 * r3);
+    r3_r2_[channel] = static_cast<T>(r3 * r2);
+    r3_r1_[channel] = static_cast<T>(r3 * r1);
+    divisor_[channel] = Utilities::InvariantDivisor<T>{static_cast<T>(r1 * r2)};
+  }
+
+  template <typename Output>
+  Output Calculate(const std::size_t channel, const T v1, const T v2,
+                   const T node) const {
+    assert(channel < kChannels);
+    const T sum = node * divider_[channel];
+    const T numerator_negative = r3_r2_[channel] * v1 + r3_r1_[channel] * v2;
+    assert(std::numeric_limits<Output>::is_signed ||
+           (sum >= numerator_negative));
+    return Utilities::StaticCastQuickFail<Output>(
+        divisor_[channel].divide(static_cast<T>(sum - numerator_negative)));
+  }
+
+  /*
+   * One sample of every channel, each pointer is kChannels long
+   */
+  template <typename Output>
+  void Process(const T *const v1, const T *const v2, const T *const node,
+               Output *const out) const {
+    Channels numerators;
+    CalculateNumerators(v1, v2, node, &numerators);
+    for (std::size_t channel = 0; channel < kChannels; channel++) {
+      out[channel] = Utilities::StaticCastQuickFail<Output>(
+          divisor_[channel].divide(numerators[channel]));
+    }
+  }
+
+  /*
+   * sample_count samples of every channel, each pointer is
+   * sample_count * kChannels long
+   */
+  template <typename Output>
+  void ProcessBlock(const T *const v1, const T *const v2, const T *const node,
+                    const std::size_t sample_count, Output *const out) const {
+    for (std::size_t sample = 0; sample < sample_count; sample++) {
+      const std::size_t offset = sample * kChannels;
+      Process(v1 + offset, v2 + offset, node + offset, out + offset);
+    }
+  }
+
+  ThreeNodeVoltageDividerBank(void) {}
+};
+}  // namespace Calculator
+
+#endif //  CALCULATORS_VOLTAGEDIVIDERBANK_H_
@@ -0,0 +1,20 @@
+/*
+ * Copyright 2020 Electrooptical Innovations
+ *
+ * Random test values shared by the calculator tests
+ * */
+#pragma once
+#ifndef CALCULATORS_TESTS_RANDOMVALUE_H_
+#define CALCULATORS_TESTS_RANDOMVALUE_H_
+
+#include <random>
+
+namespace CalculatorTests {
+//  uniform in [low, high]
+template <typename T>
+inline T Random(std::mt19937_64 *generator, const T low, const T high) {
+  return std::uniform_int_distribution<T>{low, high}(*generator);
+}
+}  // namespace CalculatorTests
+
+#endif  //  CALCULATORS_TESTS_RANDOMVALUE_H_
@@ -49,6 +49,40 @@ TEST(Calculator, ScaleToDigitalValue) {
     }
   }
 }
+TEST(Calculator, ScaleDigitalValuesBatch) {
+  const int kBits = 18;
+  const int64_t kScaleHigh[]{3300000, 5000000, 15000000};
+  const int64_t kScaleLow[]{0, -5000000, -15000000};
+  std::vector<int64_t> codes(1 << kBits);
+  for (std::size_t i = 0; i < codes.size(); i++) {
+    codes[i] = static_cast<int64_t>(i);
+  }
+  std::vector<int64_t> micro(codes.size());
+  std::vector<int64_t> round_trip(codes.size());
+  for (auto high : kScaleHigh) {
+    for (auto low : kScaleLow) {
+      Calculator::ScaleDigitalValues(codes.data(), codes.size(), kBits, low,
+                                     high, micro.data());
+      Calculator::ScaleToDigitalValues(micro.data(), micro.size(), kBits, low,
+                                       high, round_trip.data());
+      for (std::size_t i = 0; i < codes.size(); i++) {
+        ASSERT_EQ(Calculator::ScaleDigitalValue<int64_t>(codes[i], kBits, low,
+                                                         high),
+                  micro[i]);
+        //  every value in the range, not only the ones on the code grid
+        const int64_t value = low + static_cast<int64_t>(i) * (high - low) /
+                                        static_cast<int64_t>(codes.size());
+        int64_t batch = 0;
+        Calculator::ScaleToDigitalValues(&value, 1, kBits, low, high, &batch);
+        ASSERT_EQ(Calculator::ScaleToDigitalValue<int64_t>(value, kBits, low,
+                                                           high),
+                  batch);
+      }
+      EXPECT_EQ(codes, round_trip);
+    }
+  }
+}
+
 #if 0
 TEST(Calculator, ScaleToDigitalValuePrint) {
   const uint32_t kBits = 12;
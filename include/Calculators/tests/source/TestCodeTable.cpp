@@ -0,0 +1,50 @@
+/*
+ * Copyright 2020 Electrooptical Innovations
+ * */
+#include <Calculators/CalculatorBase.h>
+#include <Calculators/CodeTable.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+namespace {
+constexpr auto kScale = [](const int32_t code) {
+  return Calculator::ScaleDigitalValue<int32_t>(code, 12, -5000000, 5000000);
+};
+
+//  12 bit ADC behind a x5 non inverting amplifier
+constexpr auto kInput = [](const int32_t code) {
+  const int32_t adc = kScale(code);
+  return Calculator::AmplifierOutput<int32_t, int64_t>(adc, 0, 1000, 4000,
+                                                       25000000, -25000000);
+};
+
+constexpr auto kSquare = [](const int32_t code) {
+  return static_cast<int64_t>(code) * code;
+};
+
+constexpr Calculator::CodeTable<int32_t, 12> kScaleTable{kScale};
+static_assert(Calculator::GetMaxTableError(kScaleTable, kScale) == 0);
+static_assert(decltype(kScaleTable)::GetFootprint() == 4096 * sizeof(int32_t));
+}  // namespace
+
+TEST(CodeTable, MatchesFunction) {
+  constexpr Calculator::CodeTable<int32_t, 12> table{kInput};
+  for (int32_t code = 0; code < 4096; code++) {
+    ASSERT_EQ(kInput(code), table.Convert(static_cast<std::size_t>(code)));
+  }
+  EXPECT_EQ(0, Calculator::GetMaxTableError(table, kInput));
+}
+
+TEST(CodeTable, Interpolated) {
+  //  a straight line is exact at any knot spacing
+  constexpr Calculator::InterpolatedCodeTable<int32_t, 12, 4> linear{kScale};
+  static_assert(decltype(linear)::GetFootprint() == 17 * sizeof(int32_t));
+  EXPECT_LE(Calculator::GetMaxTableError(linear, kScale), 1);
+
+  //  chord error of x^2 over a segment of width w is w^2 / 4
+  constexpr Calculator::InterpolatedCodeTable<int64_t, 12, 6> square{kSquare};
+  EXPECT_EQ(0, square.Convert(0));
+  EXPECT_EQ(64 * 64, square.Convert(64));
+  EXPECT_EQ(64 * 64 / 4, Calculator::GetMaxTableError(square, kSquare));
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2020 Electrooptical Innovations
+ * */
+#include <Calculators/FixedScale.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <ratio>
+
+namespace {
+using OneThird = Calculator::FixedScale<std::ratio<1, 3>>;
+using Half = Calculator::FixedScale<std::ratio<1, 2>>;
+using Gain = Calculator::FixedScale<std::ratio<36000, 11000>>;
+
+static_assert(Calculator::is_fixed_scale<OneThird>::value);
+static_assert(!Calculator::is_fixed_scale<int>::value);
+static_assert(Half::kMultiplier == 1 && Half::kShift == 1);
+static_assert(Half::apply(5) == 3);
+static_assert(Half::apply(-5) == -3);
+static_assert(OneThird::apply(300) == 100);
+}  // namespace
+
+TEST(FixedScale, Apply) {
+  for (int64_t x = -100000; x <= 100000; x += 7) {
+    const double exact = static_cast<double>(x) * OneThird::kValue;
+    EXPECT_NEAR(exact, static_cast<double>(OneThird::apply(x)),
+                0.5 + std::abs(exact) * 1e-4);
+    EXPECT_EQ(-OneThird::apply(x), OneThird::apply(-x));
+    const double gained = static_cast<double>(x) * Gain::kValue;
+    EXPECT_NEAR(gained, static_cast<double>(Gain::apply(x)),
+                0.5 + std::abs(gained) * 1e-4);
+  }
+}
+
+TEST(FixedScale, Calculators) {
+  //  1k / 2k two node divider in microvolts
+  using V1Scale = Calculator::FixedScale<std::ratio<2000, 3000>>;
+  using V2Scale = Calculator::FixedScale<std::ratio<1000, 3000>>;
+  const int64_t v1 = 3300000;
+  const int64_t v2 = -1200000;
+  const int64_t node = Calculator::TwoNodeVoltageDivider<int64_t>(
+      v1, v2, V1Scale{}, V2Scale{});
+  EXPECT_LE(std::abs(Calculator::TwoNodeVoltageDivider<int64_t>(
+                         v1, v2, int64_t{1000}, int64_t{2000}) -
+                     node),
+            100);
+
+  using NodeScale = Calculator::FixedScale<std::ratio<3000, 1000>>;
+  using ReverseV1Scale = Calculator::FixedScale<std::ratio<2000, 1000>>;
+  EXPECT_LE(std::abs(v2 - Calculator::TwoNodeVoltageDividerReverse<int64_t>(
+                              v1, node, NodeScale{}, ReverseV1Scale{})),
+            300);
+
+  //  r1 = 1k, r2 = 2k, r3 = 2k: divider = 2M + 2M + 4M
+  using S1 = Calculator::FixedScale<std::ratio<4, 8>>;
+  using S2 = Calculator::FixedScale<std::ratio<2, 8>>;
+  using S3 = Calculator::FixedScale<std::ratio<2, 8>>;
+  EXPECT_EQ(Calculator::ThreeNodeVoltageDivider<int64_t>(
+                int64_t{5000000}, int64_t{0}, int64_t{1000000}, int64_t{1000},
+                int64_t{2000}, int64_t{2000}),
+            Calculator::ThreeNodeVoltageDivider<int64_t>(
+                int64_t{5000000}, int64_t{0}, int64_t{1000000}, S1{}, S2{},
+                S3{}));
+
+  const int64_t vhigh = 12000000;
+  for (int64_t in = -2000000; in <= 2000000; in += 250000) {
+    const int64_t divided = Calculator::AmplifierOutput<int64_t>(
+        in, int64_t{0}, int64_t{11000}, int64_t{36000}, vhigh, -vhigh);
+    const int64_t scaled = Calculator::AmplifierOutput<int64_t>(
+        in, int64_t{0}, Gain{}, vhigh, -vhigh);
+    EXPECT_LE(std::abs(divided - scaled), 100);
+  }
+}
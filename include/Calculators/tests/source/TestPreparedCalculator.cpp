@@ -0,0 +1,67 @@
+/*
+ * Copyright 2020 Electrooptical Innovations
+ * */
+#include <Calculators/PreparedCalculator.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <random>
+
+#include "RandomValue.h"
+
+namespace {
+using CalculatorTests::Random;
+
+template <typename T>
+void CheckMatchesCalculator(const T value_max, const T resistor_max,
+                            const unsigned seed) {
+  std::mt19937_64 generator{seed};
+  const T value_min = std::numeric_limits<T>::is_signed ? -value_max : 0;
+  for (int network = 0; network < 50; network++) {
+    const T r1 = Random<T>(&generator, 1, resistor_max);
+    const T r2 = Random<T>(&generator, 1, resistor_max);
+    const T r3 = Random<T>(&generator, 1, resistor_max);
+    const Calculator::PreparedTwoNodeVoltageDivider<T> two_node{r1, r2};
+    const Calculator::PreparedTwoNodeVoltageDividerReverse<T> two_node_reverse{
+        r1, r2};
+    const Calculator::PreparedThreeNodeVoltageDivider<T> three_node{r1, r2,
+                                                                    r3};
+    const Calculator::PreparedThreeNodeVoltageDividerReversed<T>
+        three_node_reversed{r1, r2, r3};
+    const T vhigh = value_max;
+    const T vlow = value_min / 2;
+    const Calculator::PreparedAmplifierOutput<T> amplifier{r1, r2, vhigh,
+                                                           vlow};
+    for (int sample = 0; sample < 200; sample++) {
+      const T v1 = Random<T>(&generator, value_min, value_max);
+      const T v2 = Random<T>(&generator, value_min, value_max);
+      const T v3 = Random<T>(&generator, value_min, value_max);
+      ASSERT_EQ(Calculator::TwoNodeVoltageDivider<T>(v1, v2, r1, r2),
+                two_node.template Calculate<T>(v1, v2));
+      ASSERT_EQ(Calculator::ThreeNodeVoltageDivider<T>(v1, v2, v3, r1, r2, r3),
+                three_node.template Calculate<T>(v1, v2, v3));
+      if (std::numeric_limits<T>::is_signed) {
+        ASSERT_EQ(Calculator::TwoNodeVoltageDividerReverse<T>(v1, v2, r1, r2),
+                  two_node_reverse.template Calculate<T>(v1, v2));
+        ASSERT_EQ(Calculator::ThreeNodeVoltageDividerReversed<T>(v1, v2, v3, r1,
+                                                                 r2, r3),
+                  three_node_reversed.template Calculate<T>(v1, v2, v3));
+        ASSERT_EQ(
+            Calculator::AmplifierOutput<T>(v1, v2, r1, r2, vhigh, vlow),
+            amplifier.template Calculate<T>(v1, v2));
+      }
+    }
+  }
+}
+}  // namespace
+
+TEST(PreparedCalculator, MatchesCalculator) {
+  //  microvolts and ohms, the three node products are resistor squared
+  //  times voltage
+  CheckMatchesCalculator<int64_t>(15000000, 100000, 1);
+  CheckMatchesCalculator<uint64_t>(15000000, 100000, 4);
+  //  millivolts and ohms
+  CheckMatchesCalculator<int32_t>(15000, 100, 2);
+  CheckMatchesCalculator<uint32_t>(15000, 100, 3);
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright 2020 Electrooptical Innovations
+ * */
+#include <Calculators/ThermistorCalculator.h>
+#include <TemperatureMeasurement/ThermistorDivider.h>
+#include <Utilities/math.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace {
+namespace TemperatureCalculator = Utilities::TemperatureCalculator;
+using Utilities::MathAccuracy;
+}  // namespace
+
+TEST(ThermistorModel, BetaMatchesTemperatureFromResistance) {
+  const double kR0 = 10000;
+  const double kBFactor = 3950;
+  const auto model =
+      TemperatureCalculator::MakeBetaModel<MathAccuracy::kExact>(kR0, kBFactor,
+                                                                 25);
+  const double r_inf =
+      kR0 * std::exp(-kBFactor / Utilities::CelsiusToKelvin(25));
+  for (double resistance = 100; resistance < 1e6; resistance *= 1.1) {
+    const double expected = kBFactor / std::log(resistance / r_inf);
+    EXPECT_NEAR(expected, model.Kelvin(resistance), 1e-9) << resistance;
+  }
+  EXPECT_NEAR(Utilities::CelsiusToKelvin(25), model.Kelvin(kR0), 1e-9);
+}
+
+TEST(ThermistorModel, SteinhartHartThroughPoints) {
+  //  10k NTC datasheet points at 0, 25 and 50 C
+  const double kResistance[] = {32650, 10000, 3603};
+  const double kKelvin[] = {273.15, 298.15, 323.15};
+  const auto model =
+      TemperatureCalculator::SteinhartHartFromPoints<MathAccuracy::kExact>(
+          kResistance[0], kKelvin[0], kResistance[1], kKelvin[1],
+          kResistance[2], kKelvin[2]);
+  for (int i = 0; i < 3; i++) {
+    EXPECT_NEAR(kKelvin[i], model.Kelvin(kResistance[i]), 1e-8);
+  }
+  EXPECT_EQ(0, model.coefficients[2]);
+  //  monotonic between and beyond the points
+  double last = model.Kelvin(200000);
+  for (double resistance = 200000; resistance > 500; resistance *= 0.95) {
+    const double kelvin = model.Kelvin(resistance);
+    EXPECT_GE(kelvin, last);
+    last = kelvin;
+  }
+}
+
+TEST(ThermistorModel, BatchMatchesScalar) {
+  const auto model =
+      TemperatureCalculator::MakeSteinhartHartModel(1.1e-3, 2.4e-4, 7.5e-8);
+  std::vector<double> resistance;
+  for (double r = 100; r < 1e6; r *= 1.01) {
+    resistance.push_back(r);
+  }
+  std::vector<double> kelvin(resistance.size());
+  model.Kelvin(resistance.data(), resistance.size(), kelvin.data());
+  for (std::size_t i = 0; i < resistance.size(); i++) {
+    EXPECT_EQ(model.Kelvin(resistance[i]), kelvin[i]);
+  }
+}
+
+TEST(ThermistorModel, FastLogErrorInKelvin) {
+  const auto exact =
+      TemperatureCalculator::MakeSteinhartHartModel<MathAccuracy::kExact>(
+          1.1e-3, 2.4e-4, 7.5e-8);
+  const auto fast =
+      TemperatureCalculator::MakeSteinhartHartModel(1.1e-3, 2.4e-4, 7.5e-8);
+  std::vector<double> resistance;
+  for (double r = 100; r < 1e6; r *= 1.01) {
+    resistance.push_back(r);
+  }
+  std::vector<double> kelvin(resistance.size());
+  fast.Kelvin(resistance.data(), resistance.size(), kelvin.data());
+  double max_error = 0;
+  for (std::size_t i = 0; i < resistance.size(); i++) {
+    max_error =
+        std::max(max_error, std::abs(exact.Kelvin(resistance[i]) - kelvin[i]));
+  }
+  //  about 1.2 microkelvin over 100 ohm to 1 Mohm
+  EXPECT_LT(max_error, 1e-5);
+}
+
+/*
+ * Model evaluation against table interpolation, run with
+ * --gtest_also_run_disabled_tests
+ * */
+TEST(ThermistorModel, DISABLED_BenchmarkAgainstTable) {
+  const int32_t kAdcBits = 12;
+  const int32_t kCodes = 1 << kAdcBits;
+  const double kPullup = 17400;
+  const auto temperature_to_adc =
+      TemperatureMeasurement::TemperatureToAdcTwoNodeThermistor<
+          kAdcBits, 0, 3300000, 3300000, 17400, 25, 4000, 10000>;
+  const auto table = TemperatureMeasurement::TemperatureTableMaker<
+      -30, 50, 64, decltype(temperature_to_adc)>::GetTable(temperature_to_adc);
+  const auto model = TemperatureCalculator::MakeBetaModel(10000, 4000, 25);
+
+  const std::size_t kSamples = 1 << 20;
+  std::vector<int32_t> codes(kSamples);
+  std::vector<double> resistance(kSamples);
+  for (std::size_t i = 0; i < kSamples; i++) {
+    codes[i] = static_cast<int32_t>(1 + (i * 2654435761u) % (kCodes - 2));
+    resistance[i] = kPullup * codes[i] / (kCodes - codes[i]);
+  }
+  std::vector<int32_t> micro_celsius(kSamples);
+  std::vector<double> kelvin(kSamples);
+
+  const auto start = std::chrono::steady_clock::now();
+  TemperatureMeasurement::ThermistorDividerBase::InterpolatePoints(
+      codes.data(), kSamples, table.data(), table.size(),
+      micro_celsius.data());
+  const auto table_end = std::chrono::steady_clock::now();
+  model.Kelvin(resistance.data(), kSamples, kelvin.data());
+  const auto model_end = std::chrono::steady_clock::now();
+
+  const auto ns_per_sample = [kSamples](const auto duration) {
+    return static_cast<double>(
+               std::chrono::duration_cast<std::chrono::nanoseconds>(duration)
+                   .count()) /
+           kSamples;
+  };
+  printf("table interpolation %.2f ns/sample, beta model %.2f ns/sample\n",
+         ns_per_sample(table_end - start),
+         ns_per_sample(model_end - table_end));
+  EXPECT_GT(kelvin[0], 0);
+  EXPECT_NE(micro_celsius[0], 0);
+}
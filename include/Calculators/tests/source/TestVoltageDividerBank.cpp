@@ -0,0 +1,61 @@
+/*
+ * Copyright 2020 Electrooptical Innovations
+ * */
+#include <Calculators/VoltageDividerBank.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "RandomValue.h"
+
+namespace {
+using CalculatorTests::Random;
+}  // namespace
+
+TEST(ThreeNodeVoltageDividerBank, MatchesSingleChannel) {
+  const std::size_t kChannels = 67;
+  const std::size_t kSamples = 50;
+  std::mt19937_64 generator{1};
+  Calculator::ThreeNodeVoltageDividerBank<int64_t, kChannels> bank;
+  std::vector<int64_t> r1(kChannels), r2(kChannels), r3(kChannels);
+  for (std::size_t channel = 0; channel < kChannels; channel++) {
+    r1[channel] = Random<int64_t>(&generator, 1, 100000);
+    r2[channel] = Random<int64_t>(&generator, 1, 100000);
+    r3[channel] = Random<int64_t>(&generator, 1, 100000);
+    bank.SetChannel(channel, r1[channel], r2[channel], r3[channel]);
+  }
+  const std::size_t kLength = kChannels * kSamples;
+  std::vector<int64_t> v1(kLength), v2(kLength), node(kLength);
+  for (std::size_t i = 0; i < kLength; i++) {
+    v1[i] = Random<int64_t>(&generator, -15000000, 15000000);
+    v2[i] = Random<int64_t>(&generator, -15000000, 15000000);
+    node[i] = Random<int64_t>(&generator, -15000000, 15000000);
+  }
+  std::vector<int64_t> out(kLength);
+  bank.ProcessBlock(v1.data(), v2.data(), node.data(), kSamples, out.data());
+  for (std::size_t i = 0; i < kLength; i++) {
+    const std::size_t channel = i % kChannels;
+    const auto expected =
+        Calculator::ThreeNodeVoltageDividerReversed<int64_t, int64_t>(
+            v1[i], v2[i], node[i], r1[channel], r2[channel], r3[channel]);
+    ASSERT_EQ(expected, out[i]) << i;
+    ASSERT_EQ(expected, bank.Calculate<int64_t>(channel, v1[i], v2[i],
+                                                node[i]));
+  }
+}
+
+TEST(ThreeNodeVoltageDividerBank, UnpreparedChannelsDivideByOne) {
+  Calculator::ThreeNodeVoltageDividerBank<int32_t, 4> bank;
+  bank.SetChannel(0, 1, 1, 1);
+  const int32_t v1[] = {1, 1, 1, 1};
+  const int32_t v2[] = {1, 1, 1, 1};
+  const int32_t node[] = {1, 1, 1, 1};
+  int32_t out[4];
+  bank.Process(v1, v2, node, out);
+  EXPECT_EQ(Calculator::ThreeNodeVoltageDividerReversed<int32_t>(1, 1, 1, 1,
+                                                                  1, 1),
+            out[0]);
+  EXPECT_EQ(0, out[1]);
+}
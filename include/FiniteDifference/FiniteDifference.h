@@ -12,6 +12,8 @@
 #include <algorithm>
 #include <array>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
 
 enum class BootStage { kWindow0 = 0, kWindow1 = 1, kWindow2 = 2, kDone = 3 };
 
@@ -36,6 +38,16 @@ class SecFiniteDif {
     windows.back() = 0;
   }
 
+  void complete_boxcar(void) {
+    average_count_ = 0;
+    if (!is_primed()) {
+      window_index_ += 1;
+      return;
+    }
+    assert(window_index_ == windows.size() - 1);
+    rotate_windows();
+  }
+
  public:
   void set_boxcar_length(const size_t boxcar_length) {
     boxcar_length_ = boxcar_length;
@@ -56,16 +68,60 @@ class SecFiniteDif {
     windows[window_index_] += data;
 
     if (average_count_ >= boxcar_length_) {
-      average_count_ = 0;
-      if (!is_primed()) {
-        window_index_ += 1;
-        return;
+      complete_boxcar();
+    }
+  }
+
+  /*
+   * Same as calling run on each of count samples. The samples of a boxcar
+   * are summed in one loop, which GCC vectorizes at -O3, and the boxcar
+   * check is done once per boxcar. on_window(*this) is called each time a
+   * boxcar completes.
+   * */
+  template <typename Callback>
+  void run(const int32_t* data, size_t count, const Callback& on_window) {
+    while (count > 0) {
+      const size_t remaining = boxcar_length_ > average_count_
+                                   ? boxcar_length_ - average_count_
+                                   : 1;
+      const size_t samples = remaining < count ? remaining : count;
+      //  unsigned so the partial sums wrap the same as adding one at a time
+      uint32_t sum = 0;
+      for (size_t i = 0; i < samples; i++) {
+        sum += static_cast<uint32_t>(data[i]);
+      }
+      windows[window_index_] = static_cast<int32_t>(
+          static_cast<uint32_t>(windows[window_index_]) + sum);
+      average_count_ += samples;
+      data += samples;
+      count -= samples;
+      if (average_count_ >= boxcar_length_) {
+        complete_boxcar();
+        on_window(*this);
       }
-      assert(window_index_ == windows.size() - 1);
-      rotate_windows();
     }
   }
 
+  void run(const int32_t* const data, const size_t count) {
+    run(data, count, [](const SecFiniteDif&) {});
+  }
+
+  /*
+   * Writes get_sfdiff to sfdiff for each boxcar completed once primed,
+   * returns the number written. sfdiff needs an entry for every boxcar
+   * that can complete in count samples.
+   * */
+  size_t run(const int32_t* const data, const size_t count,
+             int32_t* const sfdiff) {
+    size_t written = 0;
+    run(data, count, [sfdiff, &written](const SecFiniteDif& finite_dif) {
+      if (finite_dif.is_primed()) {
+        sfdiff[written++] = finite_dif.get_sfdiff();
+      }
+    });
+    return written;
+  }
+
   int32_t get_sfdiff(void) const {
     /*
      * The actual sfdiff is this value divided by the (boxcar length)**3 as we
@@ -122,4 +178,233 @@ class SecFiniteDif {
       : boxcar_length_{box_car_length} {}
 };
 
+/*
+ * SecFiniteDif for kChannels channels sampled together, so the boxcar count
+ * and boot stage are shared and only the window sums are per channel. Each
+ * window is an array over the channels, adding a sample of every channel is
+ * an element wise loop. The block versions sum into locals the samples can
+ * not alias, run_block 16 channels at a time. GCC vectorizes run_block from
+ * -O2, run and run_planar at -O3. The windows are a ring, a completed
+ * boxcar moves the start instead of copying the windows.
+ * Results per channel are the same as a SecFiniteDif given the same samples.
+ * */
+template <size_t kChannels>
+class SecFiniteDifBank {
+ public:
+  static const size_t kWindowCount = SecFiniteDif::kWindowCount;
+
+ private:
+  size_t boxcar_length_ = 0;
+  size_t average_count_ = 0;
+  size_t window_index_ = 0;
+  //  physical window of logical window 0, the oldest
+  size_t first_window_ = 0;
+  //  unsigned so the sums wrap the same as SecFiniteDif::run on a block
+  using Sums = std::array<uint32_t, kChannels>;
+  std::array<Sums, kWindowCount> windows_{};
+
+  int32_t get_sum(const size_t window, const size_t channel) const {
+    return static_cast<int32_t>(
+        windows_[(first_window_ + window) % kWindowCount][channel]);
+  }
+
+  Sums& get_filling_window(void) {
+    return windows_[(first_window_ + window_index_) % kWindowCount];
+  }
+
+  //  channels summed at once in a local copy, bounds the stack used
+  static const size_t kTileChannels = 16;
+
+  //  count samples of kWidth channels, the rows are kChannels apart
+  template <size_t kWidth>
+  static void add_tile(uint32_t* const window, const int32_t* const data,
+                       const size_t count) {
+    //  a local copy, the window could alias data
+    std::array<uint32_t, kWidth> tile;
+    std::copy_n(window, kWidth, tile.begin());
+    for (size_t sample = 0; sample < count; sample++) {
+      for (size_t channel = 0; channel < kWidth; channel++) {
+        tile[channel] +=
+            static_cast<uint32_t>(data[sample * kChannels + channel]);
+      }
+    }
+    std::copy_n(tile.begin(), kWidth, window);
+  }
+
+  //  count samples of every channel, channel fastest, into the filling window
+  void add_block(const int32_t* const data, const size_t count) {
+    uint32_t* const window = get_filling_window().data();
+    size_t first = 0;
+    for (; first + kTileChannels <= kChannels; first += kTileChannels) {
+      add_tile<kTileChannels>(window + first, data + first, count);
+    }
+    const constexpr size_t kRest = kChannels % kTileChannels;
+    if constexpr (kRest > 0) {
+      add_tile<kRest>(window + first, data + first, count);
+    }
+  }
+
+  //  samples to add before the current boxcar completes
+  size_t get_remaining(void) const {
+    return boxcar_length_ > average_count_ ? boxcar_length_ - average_count_
+                                           : 1;
+  }
+
+  void add_samples(const size_t count) {
+    average_count_ += count;
+    if (average_count_ < boxcar_length_) {
+      return;
+    }
+    average_count_ = 0;
+    if (!is_primed()) {
+      window_index_ += 1;
+      return;
+    }
+    //  the oldest window becomes the one being filled
+    Sums& oldest = windows_[first_window_];
+    std::fill(oldest.begin(), oldest.end(), 0);
+    first_window_ = (first_window_ + 1) % kWindowCount;
+  }
+
+ public:
+  static constexpr size_t get_channel_count(void) { return kChannels; }
+
+  void set_boxcar_length(const size_t boxcar_length) {
+    boxcar_length_ = boxcar_length;
+  }
+
+  bool is_primed(void) const { return window_index_ >= kWindowCount - 1; }
+
+  void reset(void) {
+    average_count_ = 0;
+    window_index_ = 0;
+    first_window_ = 0;
+    for (Sums& window : windows_) {
+      std::fill(window.begin(), window.end(), 0);
+    }
+  }
+
+  /*
+   * One sample of every channel
+   * */
+  void run(const int32_t* const data) {
+    Sums& window = get_filling_window();
+    for (size_t channel = 0; channel < kChannels; channel++) {
+      window[channel] += static_cast<uint32_t>(data[channel]);
+    }
+    add_samples(1);
+  }
+
+  /*
+   * sample_count samples of every channel, channel fastest. Sample s of
+   * channel c is at s * kChannels + c.
+   * */
+  void run_block(const int32_t* data, size_t sample_count) {
+    while (sample_count > 0) {
+      const size_t remaining = get_remaining();
+      const size_t count = remaining < sample_count ? remaining : sample_count;
+      add_block(data, count);
+      add_samples(count);
+      data += count * kChannels;
+      sample_count -= count;
+    }
+  }
+
+  /*
+   * sample_count samples of every channel, one channel after another. Sample
+   * s of channel c is at c * sample_count + s.
+   * */
+  void run_planar(const int32_t* const data, const size_t sample_count) {
+    size_t offset = 0;
+    while (offset < sample_count) {
+      const size_t remaining = get_remaining();
+      const size_t count = remaining < sample_count - offset
+                               ? remaining
+                               : sample_count - offset;
+      Sums& window = get_filling_window();
+      for (size_t channel = 0; channel < kChannels; channel++) {
+        const int32_t* const samples = data + channel * sample_count + offset;
+        //  a local sum, the window could alias data
+        uint32_t sum = 0;
+        for (size_t sample = 0; sample < count; sample++) {
+          sum += static_cast<uint32_t>(samples[sample]);
+        }
+        window[channel] += sum;
+      }
+      add_samples(count);
+      offset += count;
+    }
+  }
+
+  int32_t get_sfdiff(const size_t channel) const {
+    if (!is_primed()) {
+      return 0;
+    }
+    const int64_t oldest = get_sum(0, channel);
+    const int64_t middle = get_sum(1, channel);
+    const int64_t newest = get_sum(2, channel);
+    return static_cast<int32_t>(oldest - 2 * middle + newest);
+  }
+
+  int32_t get_fdiff(const size_t channel) const {
+    if (!is_primed()) {
+      return 0;
+    }
+    return static_cast<int32_t>(static_cast<int64_t>(get_sum(2, channel)) -
+                                static_cast<int64_t>(get_sum(1, channel)));
+  }
+
+  int32_t get_value(const size_t channel) const {
+    if (!is_primed()) {
+      return 0;
+    }
+    return get_sum(2, channel);
+  }
+
+  int32_t get_newest_boxcar(const size_t channel) const {
+    if (is_primed()) return get_sum(kWindowCount - 2, channel);
+    return window_index_ > 0 ? get_sum(window_index_ - 1, channel) : 0;
+  }
+
+  /*
+   * Every channel at once, out is kChannels long
+   * */
+  void get_sfdiffs(int32_t* const out) const {
+    for (size_t channel = 0; channel < kChannels; channel++) {
+      out[channel] = get_sfdiff(channel);
+    }
+  }
+
+  void get_fdiffs(int32_t* const out) const {
+    for (size_t channel = 0; channel < kChannels; channel++) {
+      out[channel] = get_fdiff(channel);
+    }
+  }
+
+  void get_values(int32_t* const out) const {
+    for (size_t channel = 0; channel < kChannels; channel++) {
+      out[channel] = get_value(channel);
+    }
+  }
+
+  void get_newest_boxcars(int32_t* const out) const {
+    for (size_t channel = 0; channel < kChannels; channel++) {
+      out[channel] = get_newest_boxcar(channel);
+    }
+  }
+
+  BootStage get_status() const {
+    if (is_primed()) return BootStage::kDone;
+    switch (window_index_) {
+      case 0:  return BootStage::kWindow0;
+      case 1:  return BootStage::kWindow1;
+      case 2:  return BootStage::kWindow2;
+      default: return BootStage::kDone;
+    }
+  }
+
+  explicit SecFiniteDifBank(const size_t box_car_length = 0)
+      : boxcar_length_{box_car_length} {}
+};
+
 #endif  //  FINITEDIFFERENCE_FINITEDIFFERENCE_H_
@@ -188,3 +188,206 @@ TEST(FiniteDifferencer, ParabolicValues) {
             sdiff.get_sfdiff());  //  Entering a parabola, so the second diff
                                   //  should be the gain
 }
+
+namespace {
+const constexpr std::size_t kBankChannels = 5;
+
+//  deterministic noise around a parabola, different for every channel
+std::vector<int32_t> MakeBankSamples(std::size_t sample_count) {
+  std::vector<int32_t> data(sample_count * kBankChannels);
+  uint32_t state = 12345;
+  for (std::size_t sample = 0; sample < sample_count; sample++) {
+    for (std::size_t channel = 0; channel < kBankChannels; channel++) {
+      state = state * 1664525u + 1013904223u;
+      const int32_t noise = static_cast<int32_t>(state >> 20) - 2048;
+      const int32_t x = static_cast<int32_t>(sample % 200);
+      data[sample * kBankChannels + channel] =
+          static_cast<int32_t>(channel + 1) * x * x + noise;
+    }
+  }
+  return data;
+}
+
+void ExpectBankMatches(const SecFiniteDifBank<kBankChannels>& bank,
+                       const std::vector<SecFiniteDif>& channels) {
+  std::array<int32_t, kBankChannels> sfdiff{};
+  std::array<int32_t, kBankChannels> fdiff{};
+  std::array<int32_t, kBankChannels> value{};
+  std::array<int32_t, kBankChannels> newest{};
+  bank.get_sfdiffs(sfdiff.data());
+  bank.get_fdiffs(fdiff.data());
+  bank.get_values(value.data());
+  bank.get_newest_boxcars(newest.data());
+  for (std::size_t channel = 0; channel < kBankChannels; channel++) {
+    const SecFiniteDif& single = channels[channel];
+    EXPECT_TRUE(bank.get_status() == single.get_status());
+    EXPECT_EQ(sfdiff[channel], single.get_sfdiff());
+    EXPECT_EQ(fdiff[channel], single.get_fdiff());
+    EXPECT_EQ(value[channel], single.get_value());
+    EXPECT_EQ(newest[channel], single.get_newest_boxcar());
+    EXPECT_EQ(bank.get_sfdiff(channel), single.get_sfdiff());
+  }
+}
+}  //  namespace
+
+TEST(FiniteDifferencer, BankMatchesSingleChannel) {
+  const std::size_t kSamples = 1000;
+  const auto data = MakeBankSamples(kSamples);
+  for (const std::size_t boxcar_length : {0, 1, 7, boxcarLen}) {
+    SecFiniteDifBank<kBankChannels> bank{boxcar_length};
+    std::vector<SecFiniteDif> channels(kBankChannels,
+                                       SecFiniteDif{boxcar_length});
+    std::size_t sample = 0;
+    std::size_t block = 1;
+    while (sample < kSamples) {
+      const std::size_t count =
+          kSamples - sample < block ? kSamples - sample : block;
+      if (block == 1) {
+        bank.run(&data[sample * kBankChannels]);
+      } else {
+        bank.run_block(&data[sample * kBankChannels], count);
+      }
+      for (std::size_t i = sample; i < sample + count; i++) {
+        for (std::size_t channel = 0; channel < kBankChannels; channel++) {
+          channels[channel].run(data[i * kBankChannels + channel]);
+        }
+      }
+      ExpectBankMatches(bank, channels);
+      sample += count;
+      block = block % 37 + 3;
+    }
+    bank.reset();
+    EXPECT_TRUE(bank.get_status() == BootStage::kWindow0);
+    EXPECT_EQ(bank.get_newest_boxcar(0), 0);
+  }
+}
+
+TEST(FiniteDifferencer, BankPlanarMatchesInterleaved) {
+  const std::size_t kSamples = 300;
+  const auto data = MakeBankSamples(kSamples);
+  std::vector<int32_t> planar(data.size());
+  for (std::size_t sample = 0; sample < kSamples; sample++) {
+    for (std::size_t channel = 0; channel < kBankChannels; channel++) {
+      planar[channel * kSamples + sample] =
+          data[sample * kBankChannels + channel];
+    }
+  }
+  SecFiniteDifBank<kBankChannels> interleaved{boxcarLen};
+  SecFiniteDifBank<kBankChannels> per_channel{boxcarLen};
+  interleaved.run_block(data.data(), kSamples);
+  per_channel.run_planar(planar.data(), kSamples);
+  EXPECT_TRUE(per_channel.get_status() == BootStage::kDone);
+  for (std::size_t channel = 0; channel < kBankChannels; channel++) {
+    EXPECT_EQ(per_channel.get_sfdiff(channel), interleaved.get_sfdiff(channel));
+    EXPECT_EQ(per_channel.get_fdiff(channel), interleaved.get_fdiff(channel));
+    EXPECT_EQ(per_channel.get_newest_boxcar(channel),
+              interleaved.get_newest_boxcar(channel));
+  }
+}
+
+TEST(FiniteDifferencer, BlockMatchesSingleSamples) {
+  const std::size_t kSamples = 2000;
+  std::vector<int32_t> data(kSamples);
+  uint32_t state = 777;
+  for (std::size_t i = 0; i < kSamples; i++) {
+    state = state * 1664525u + 1013904223u;
+    const int32_t x = static_cast<int32_t>(i % 300);
+    data[i] = 3 * x * x + static_cast<int32_t>(state >> 20) - 2048;
+  }
+  for (const std::size_t boxcar_length : {0, 1, 7, boxcarLen, 64}) {
+    const std::size_t boxcar_samples = boxcar_length ? boxcar_length : 1;
+    FiniteDifferenceTester block{boxcar_length};
+    FiniteDifferenceTester single{boxcar_length};
+    std::vector<int32_t> expected;
+    std::vector<int32_t> written(kSamples);
+    std::size_t written_count = 0;
+    std::size_t sample = 0;
+    std::size_t block_size = 1;
+    while (sample < kSamples) {
+      const std::size_t count =
+          kSamples - sample < block_size ? kSamples - sample : block_size;
+      written_count +=
+          block.run(&data[sample], count, &written[written_count]);
+      for (std::size_t i = sample; i < sample + count; i++) {
+        single.run(data[i]);
+        const bool completed = (i + 1) % boxcar_samples == 0;
+        if (completed && single.is_primed()) {
+          expected.push_back(single.get_sfdiff());
+        }
+      }
+      EXPECT_TRUE(block.get_status() == single.get_status());
+      for (std::size_t window = 0; window < SecFiniteDif::kWindowCount;
+           window++) {
+        EXPECT_EQ(block.GetWindow(window), single.GetWindow(window));
+      }
+      EXPECT_EQ(block.get_sfdiff(), single.get_sfdiff());
+      EXPECT_EQ(block.get_fdiff(), single.get_fdiff());
+      sample += count;
+      block_size = block_size * 3 % 251 + 1;
+    }
+    written.resize(written_count);
+    EXPECT_EQ(written, expected);
+  }
+}
+
+TEST(FiniteDifferencer, BlockCallback) {
+  std::vector<int32_t> data(10 * boxcarLen, 500);
+  SecFiniteDif sdiff{boxcarLen};
+  std::size_t windows = 0;
+  sdiff.run(data.data(), data.size() - 1,
+            [&windows](const SecFiniteDif& finite_dif) {
+              windows++;
+              EXPECT_EQ(finite_dif.get_sfdiff(), 0);
+            });
+  EXPECT_EQ(windows, 9u);
+  EXPECT_EQ(sdiff.get_newest_boxcar(), 500 * boxcarLen);
+  sdiff.run(data.data(), 1);
+  EXPECT_TRUE(sdiff.get_status() == BootStage::kDone);
+}
+
+TEST(FiniteDifferencer, BankWrapsLikeBlockRun) {
+  //  boxcar sums past the int32_t range wrap the same on both block paths
+  const std::size_t kSamples = 64;
+  std::vector<int32_t> data(kSamples * kBankChannels);
+  for (std::size_t i = 0; i < data.size(); i++) {
+    data[i] = 2000000000 - static_cast<int32_t>(i) * 1000;
+  }
+  SecFiniteDifBank<kBankChannels> bank{8};
+  bank.run_block(data.data(), kSamples);
+  for (std::size_t channel = 0; channel < kBankChannels; channel++) {
+    std::vector<int32_t> samples(kSamples);
+    for (std::size_t sample = 0; sample < kSamples; sample++) {
+      samples[sample] = data[sample * kBankChannels + channel];
+    }
+    SecFiniteDif single{8};
+    single.run(samples.data(), samples.size());
+    EXPECT_EQ(bank.get_sfdiff(channel), single.get_sfdiff());
+    EXPECT_EQ(bank.get_fdiff(channel), single.get_fdiff());
+    EXPECT_EQ(bank.get_newest_boxcar(channel), single.get_newest_boxcar());
+  }
+}
+
+TEST(FiniteDifferencer, WideBankBlockMatchesSingleSamples) {
+  //  two full tiles of 16 channels and a partial one
+  const std::size_t kChannels = 37;
+  const std::size_t kSamples = 200;
+  std::vector<int32_t> data(kSamples * kChannels);
+  uint32_t state = 99;
+  for (std::size_t i = 0; i < data.size(); i++) {
+    state = state * 1664525u + 1013904223u;
+    data[i] = static_cast<int32_t>(state >> 12) - (1 << 19);
+  }
+  SecFiniteDifBank<kChannels> block{boxcarLen};
+  SecFiniteDifBank<kChannels> single{boxcarLen};
+  block.run_block(data.data(), kSamples);
+  for (std::size_t sample = 0; sample < kSamples; sample++) {
+    single.run(&data[sample * kChannels]);
+  }
+  EXPECT_TRUE(block.get_status() == BootStage::kDone);
+  for (std::size_t channel = 0; channel < kChannels; channel++) {
+    EXPECT_EQ(block.get_sfdiff(channel), single.get_sfdiff(channel));
+    EXPECT_EQ(block.get_fdiff(channel), single.get_fdiff(channel));
+    EXPECT_EQ(block.get_newest_boxcar(channel),
+              single.get_newest_boxcar(channel));
+  }
+}
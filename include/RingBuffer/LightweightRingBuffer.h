@@ -3,6 +3,7 @@
  * */
 #pragma once
 #define ALIGNED(x) __attribute__((aligned(x)))
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <cstdint>
@@ -91,6 +92,31 @@ class LightWeightRingBuffer {
     return insert(in);
   }
 
+  /*
+   * Zero copy insertion: fill the free region starting at head, then the one
+   * wrapped to the start of the buffer, then publish with CommitInsert.
+   * */
+  std::size_t GetFreeCount(void) const { return size() - GetCount(); }
+
+  T *GetInsertRegion(std::size_t *const length) {
+    //  when empty the head may sit anywhere, the first region stops at the end
+    *length = std::min(GetFreeCount(), size() - GetHead());
+    return &buffer_[GetHead()];
+  }
+
+  T *GetWrappedInsertRegion(std::size_t *const length) {
+    std::size_t first = 0;
+    GetInsertRegion(&first);
+    *length = GetFreeCount() - first;
+    return buffer_.data();
+  }
+
+  std::size_t CommitInsert(std::size_t count) {
+    count = std::min(count, GetFreeCount());
+    head += static_cast<uint32_t>(count);
+    return count;
+  }
+
   void reset(void) {
     head = 0;
     tail = 0;
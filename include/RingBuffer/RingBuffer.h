@@ -57,6 +57,17 @@ class RingBuffer final : public Buffer<T> {
 
   void peek(T *out, const std::size_t pos) const { buffer_.peek(out, pos); }
 
+  std::size_t GetFreeCount(void) const { return buffer_.GetFreeCount(); }
+  T *GetInsertRegion(std::size_t *const length) {
+    return buffer_.GetInsertRegion(length);
+  }
+  T *GetWrappedInsertRegion(std::size_t *const length) {
+    return buffer_.GetWrappedInsertRegion(length);
+  }
+  std::size_t CommitInsert(const std::size_t count) {
+    return buffer_.CommitInsert(count);
+  }
+
   virtual void Reset(void) { buffer_.reset(); }
 
   [[deprecated]] void reset() { Reset(); }
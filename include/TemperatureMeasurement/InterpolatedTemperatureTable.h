@@ -0,0 +1,117 @@
+/*
+ * Copyright 2020 ElectroOptical Innovations, LLC
+ * */
+
+#pragma once
+#ifndef TEMPERATUREMEASUREMENT_INTERPOLATEDTEMPERATURETABLE_H_
+#define TEMPERATUREMEASUREMENT_INTERPOLATEDTEMPERATURETABLE_H_
+
+#include <TemperatureMeasurement/ThermistorDivider.h>
+#include <Utilities/TypeConversion.h>
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
+
+namespace TemperatureMeasurement {
+/*
+ * Column layout of a TemperatureTableMaker table. The adc readings the
+ * search compares are contiguous and can be narrowed to a 16 bit KeyType, t0
+ * and the slope are only read for the matched entry. The search halves the
+ * range branch free until it is kCountWidth keys then counts the keys at or
+ * above the reading in a compare and add loop, which GCC vectorizes at -O3.
+ * Results are the same as the ThermistorDividerBase searches.
+ * */
+template <std::size_t kNumPoints, typename KeyType = int32_t>
+class InterpolatedTemperatureTable {
+  static_assert(std::is_integral<KeyType>::value &&
+                    sizeof(KeyType) <= sizeof(int32_t),
+                "Key must be an integer of 32 bits or less");
+  static_assert(kNumPoints > 0, "Table is empty");
+  static const constexpr std::size_t kCountWidth = 32;
+
+  std::array<KeyType, kNumPoints> adc_reading_{};
+  std::array<int32_t, kNumPoints> t0_{};
+  std::array<int32_t, kNumPoints> slope_{};
+
+ public:
+  static constexpr std::size_t size(void) { return kNumPoints; }
+
+  //  bytes used by the columns, the key column alone is what a search reads
+  static constexpr std::size_t GetFootprint(void) {
+    return kNumPoints * (sizeof(KeyType) + 2 * sizeof(int32_t));
+  }
+  static constexpr std::size_t GetKeyFootprint(void) {
+    return kNumPoints * sizeof(KeyType);
+  }
+
+  constexpr int32_t GetAdcReading(const std::size_t i) const {
+    return adc_reading_[i];
+  }
+
+  constexpr InterpolatedTemperatureLine GetLine(const std::size_t i) const {
+    return InterpolatedTemperatureLine{adc_reading_[i], t0_[i], slope_[i]};
+  }
+
+  /*
+   * Index of the first entry in [begin, end) reading below adc_reading
+   * */
+  constexpr std::size_t CountReadingsAtOrAbove(const int32_t adc_reading,
+                                               std::size_t begin,
+                                               std::size_t end) const {
+    while (end - begin > kCountWidth) {
+      const std::size_t half = (end - begin) / 2;
+      const bool above = adc_reading_[begin + half - 1] >= adc_reading;
+      begin = above ? begin + half : begin;
+      end = above ? end : begin + half;
+    }
+    std::size_t count = begin;
+    for (std::size_t i = begin; i < end; i++) {
+      count += adc_reading_[i] >= adc_reading ? 1 : 0;
+    }
+    return count;
+  }
+
+  constexpr std::size_t FindMatchingIndexLower(const std::size_t index) const {
+    const std::size_t above =
+        CountReadingsAtOrAbove(static_cast<int32_t>(index), 0, kNumPoints);
+    return above < kNumPoints ? above : kNumPoints - 1;
+  }
+
+  constexpr std::size_t FindClosestMatchingIndex(
+      const std::size_t index) const {
+    const int32_t adc_reading = static_cast<int32_t>(index);
+    const std::size_t above =
+        CountReadingsAtOrAbove(adc_reading, 0, kNumPoints);
+    if (above == kNumPoints) {
+      return kNumPoints - 1;
+    }
+    if (above > 0) {
+      const int32_t error_above = adc_reading_[above - 1] - adc_reading;
+      const int32_t error_below = adc_reading - adc_reading_[above];
+      if (error_below > error_above) {
+        return above - 1;
+      }
+    }
+    //  last of a run of equal readings
+    return CountReadingsAtOrAbove(adc_reading_[above], above, kNumPoints) - 1;
+  }
+
+  constexpr int32_t GetMicroCelsius(const std::size_t index) const {
+    return ThermistorDividerBase::InterpolatePoint(
+        static_cast<int32_t>(index), GetLine(FindClosestMatchingIndex(index)));
+  }
+
+  explicit constexpr InterpolatedTemperatureTable(
+      const std::array<InterpolatedTemperatureLine, kNumPoints>& table) {
+    for (std::size_t i = 0; i < kNumPoints; i++) {
+      adc_reading_[i] =
+          Utilities::StaticCastQuickFail<KeyType>(table[i].adc_reading);
+      t0_[i] = table[i].t0;
+      slope_[i] = table[i].DeltaTByDeltaADCSlope;
+    }
+  }
+};
+}  //  namespace TemperatureMeasurement
+#endif  //  TEMPERATUREMEASUREMENT_INTERPOLATEDTEMPERATURETABLE_H_
@@ -0,0 +1,239 @@
+/*
+ * Copyright 2020 ElectroOptical Innovations, LLC
+ * */
+
+#pragma once
+#ifndef TEMPERATUREMEASUREMENT_RUNTIMETEMPERATURETABLE_H_
+#define TEMPERATUREMEASUREMENT_RUNTIMETEMPERATURETABLE_H_
+
+#include <Calculators/CalculatorBase.h>
+#include <Calculators/ThermistorCalculator.h>
+#include <TemperatureMeasurement/ThermistorDivider.h>
+#include <Utilities/TypeConversion.h>
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+
+namespace TemperatureMeasurement {
+/*
+ * TemperatureTableMaker table that can be recalibrated while it is in use.
+ * There are two copies, readers use the active one and the writer builds
+ * the other then swaps them, read copy update style. Readers never wait,
+ * they count themselves in on the copy they use and retry in the rare case
+ * a swap lands between picking the copy and counting in. The writer waits
+ * for the readers of the old copy to leave before reusing it.
+ *
+ * Only one writer at a time. Rebuild and Refit spin until the readers of
+ * the old copy leave, so they must not preempt a reader (a reader in an
+ * interrupt is fine, a writer in one is not). TryRebuild and TryRefit return
+ * kReadersBusy instead of waiting, for a writer that has to yield to let the
+ * reader finish.
+ *
+ * A calibration that puts two neighbouring points on the same adc reading
+ * has no slope between them. The writes return kEqualReadings and leave the
+ * active table as it was.
+ * */
+template <std::size_t kNumPoints>
+class RuntimeTemperatureTable {
+  static_assert(kNumPoints >= 2, "Need at least two points");
+  using Table = std::array<InterpolatedTemperatureLine, kNumPoints>;
+
+ public:
+  enum class WriteResult { kPublished, kReadersBusy, kEqualReadings };
+
+ private:
+  int32_t celsius_start_;
+  double step_size_;
+  std::array<Table, 2> tables_{};
+  std::atomic<std::size_t> active_{0};
+  mutable std::array<std::atomic<uint32_t>, 2> readers_{};
+  std::atomic<uint32_t> generation_{0};
+
+  class ReadPin {
+    std::atomic<uint32_t>* readers_;
+
+   public:
+    explicit ReadPin(std::atomic<uint32_t>* readers) : readers_{readers} {}
+    ~ReadPin() { readers_->fetch_sub(1); }
+    ReadPin(const ReadPin&) = delete;
+    ReadPin& operator=(const ReadPin&) = delete;
+  };
+
+  template <typename F>
+  InterpolatedTemperatureLine MakePoint(const std::size_t i,
+                                        const F& TemperatureToAdc) const {
+    const double t = celsius_start_ + static_cast<double>(i) * step_size_;
+    const auto adc_reading = TemperatureToAdc(Utilities::CelsiusToKelvin(t));
+    assert(adc_reading >= 0);
+    InterpolatedTemperatureLine point{};
+    point.adc_reading = Utilities::StaticCastQuickFail<int32_t>(adc_reading);
+    point.t0 = Utilities::StaticCastQuickFail<int32_t>(
+        Utilities::round<double, int32_t>(
+            Calculator::TranslateToMicro<double>(t)));
+    return point;
+  }
+
+  //  every slope set by SetSlopes over the same range has a divisor
+  static bool IsDecreasing(const Table& table, const std::size_t first,
+                           const std::size_t last) {
+    for (std::size_t i = first; i < last && i + 1 < kNumPoints; i++) {
+      if (table[i].adc_reading <= table[i + 1].adc_reading) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static void SetSlopes(Table* const table, const std::size_t first,
+                        const std::size_t last) {
+    for (std::size_t i = first; i < last && i + 1 < kNumPoints; i++) {
+      assert((*table)[i].adc_reading > (*table)[i + 1].adc_reading);
+      (*table)[i].DeltaTByDeltaADCSlope =
+          CalculateSlopeBetweenPoints((*table)[i], (*table)[i + 1]);
+    }
+    //  last point has same slope as preceeding one
+    (*table)[kNumPoints - 1].DeltaTByDeltaADCSlope =
+        (*table)[kNumPoints - 2].DeltaTByDeltaADCSlope;
+  }
+
+  static void CpuRelax(void) {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_ia32_pause();
+#elif defined(__GNUC__) && (defined(__arm__) || defined(__aarch64__))
+    __asm__ volatile("yield");
+#endif
+  }
+
+  //  the copy not in use, nullptr while readers of the last swap remain
+  Table* TryBeginWrite(void) {
+    const std::size_t inactive = 1 - active_.load();
+    return readers_[inactive].load() == 0 ? &tables_[inactive] : nullptr;
+  }
+
+  Table* BeginWrite(void) {
+    Table* table = TryBeginWrite();
+    while (table == nullptr) {
+      CpuRelax();
+      table = TryBeginWrite();
+    }
+    return table;
+  }
+
+  void Publish(void) {
+    active_.store(1 - active_.load());
+    generation_.fetch_add(1);
+  }
+
+  //  rebuild points first to first + count - 1 into table and swap it in
+  template <typename F>
+  WriteResult Write(Table* const table, const F& TemperatureToAdc,
+                    const std::size_t first, const std::size_t count) {
+    assert(first + count <= kNumPoints);
+    if (table == nullptr) {
+      return WriteResult::kReadersBusy;
+    }
+    if (count < kNumPoints) {
+      *table = tables_[active_.load()];
+    }
+    for (std::size_t i = first; i < first + count; i++) {
+      (*table)[i] = MakePoint(i, TemperatureToAdc);
+    }
+    //  the slope into the first point changes too
+    const std::size_t slope_first = first ? first - 1 : 0;
+    if (!IsDecreasing(*table, slope_first, first + count)) {
+      return WriteResult::kEqualReadings;
+    }
+    SetSlopes(table, slope_first, first + count);
+    Publish();
+    return WriteResult::kPublished;
+  }
+
+ public:
+  static constexpr std::size_t size(void) { return kNumPoints; }
+
+  double GetPointCelsius(const std::size_t i) const {
+    return celsius_start_ + static_cast<double>(i) * step_size_;
+  }
+
+  //  incremented on every swap
+  uint32_t GetGeneration(void) const { return generation_.load(); }
+
+  /*
+   * Call visit(table, size) with the active copy held for the duration
+   * */
+  template <typename Visitor>
+  auto Read(const Visitor& visit) const {
+    std::size_t index = active_.load();
+    for (;;) {
+      readers_[index].fetch_add(1);
+      //  a swap after this point sees the count
+      const std::size_t check = active_.load();
+      if (check == index) {
+        break;
+      }
+      readers_[index].fetch_sub(1);
+      index = check;
+    }
+    const ReadPin pin{&readers_[index]};
+    return visit(static_cast<const InterpolatedTemperatureLine*>(
+                     tables_[index].data()),
+                 kNumPoints);
+  }
+
+  int32_t GetMicroCelsius(const std::size_t adc_reading) const {
+    return Read([adc_reading](const InterpolatedTemperatureLine* const table,
+                              const std::size_t array_size) {
+      const std::size_t index = ThermistorDividerBase::FindClosestMatchingIndex(
+          adc_reading, table, array_size);
+      return ThermistorDividerBase::InterpolatePoint(
+          static_cast<int32_t>(adc_reading), table[index]);
+    });
+  }
+
+  /*
+   * Build every point from a new calibration then swap it in
+   * */
+  template <typename F>
+  WriteResult Rebuild(const F& TemperatureToAdc) {
+    return Write(BeginWrite(), TemperatureToAdc, 0, kNumPoints);
+  }
+
+  template <typename F>
+  WriteResult TryRebuild(const F& TemperatureToAdc) {
+    return Write(TryBeginWrite(), TemperatureToAdc, 0, kNumPoints);
+  }
+
+  /*
+   * Rebuild points first to first + count - 1 only, for a calibration that
+   * covers part of the range. The other points and slopes are copied.
+   * */
+  template <typename F>
+  WriteResult Refit(const F& TemperatureToAdc, const std::size_t first,
+                    const std::size_t count) {
+    return Write(BeginWrite(), TemperatureToAdc, first, count);
+  }
+
+  template <typename F>
+  WriteResult TryRefit(const F& TemperatureToAdc, const std::size_t first,
+                       const std::size_t count) {
+    return Write(TryBeginWrite(), TemperatureToAdc, first, count);
+  }
+
+  template <typename F>
+  RuntimeTemperatureTable(const int32_t celsius_start,
+                          const int32_t celsius_end, const F& TemperatureToAdc)
+      : celsius_start_{celsius_start},
+        step_size_{static_cast<double>(celsius_end - celsius_start) /
+                   static_cast<double>(kNumPoints - 1)} {
+    assert(celsius_start < celsius_end);
+    for (std::size_t i = 0; i < kNumPoints; i++) {
+      tables_[0][i] = MakePoint(i, TemperatureToAdc);
+    }
+    assert(IsDecreasing(tables_[0], 0, kNumPoints));
+    SetSlopes(&tables_[0], 0, kNumPoints);
+  }
+};
+}  //  namespace TemperatureMeasurement
+#endif  //  TEMPERATUREMEASUREMENT_RUNTIMETEMPERATURETABLE_H_
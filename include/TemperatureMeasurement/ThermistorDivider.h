@@ -32,35 +32,69 @@ struct InterpolatedTemperatureLine {
   int32_t DeltaTByDeltaADCSlope = 0;
 };
 
+/*
+ * Beta model thermistor in a two node divider with runtime parameters, for
+ * sensors calibrated in the field. Gives the same ADC value as
+ * TemperatureToAdcTwoNodeThermistor with the same parameters.
+ * */
+struct TwoNodeThermistor {
+  int32_t adc_bits = 12;
+  int32_t thermistor_micro_volts = 0;
+  int32_t fixed_micro_volts = 0;
+  int32_t adc_reference_micro_volts = 0;
+  int32_t fixed_resistor = 0;
+  int32_t t0_celsius = 25;
+  int32_t b_factor = 0;
+  int32_t r0 = 0;
+
+  constexpr int32_t operator()(const double kelvin) const {
+    const auto r_inf = Utilities::TemperatureCalculator::Calculate_r_inf(
+        r0, b_factor, t0_celsius);
+    assert(r_inf > 0);
+    const auto thermistor_resistance =
+        Utilities::TemperatureCalculator::ResistanceFromTemperature(
+            kelvin, b_factor, r_inf);
+    const auto thermistor_resistance_rounded =
+        Utilities::round<decltype(thermistor_resistance), int64_t>(
+            thermistor_resistance);
+    const auto thermistor_resistance_int =
+        Utilities::StaticCastQuickFail<int64_t>(thermistor_resistance_rounded);
+    assert(thermistor_resistance_int > 0);
+    const auto node_micro_volts = Calculator::TwoNodeVoltageDivider<int64_t>(
+        static_cast<int64_t>(thermistor_micro_volts),
+        static_cast<int64_t>(fixed_micro_volts), thermistor_resistance_int,
+        static_cast<int64_t>(fixed_resistor));
+    return Utilities::StaticCastQuickFail<int32_t>(
+        Calculator::ScaleToDigitalValue<int64_t>(
+            node_micro_volts, static_cast<int>(adc_bits), int64_t{0},
+            static_cast<int64_t>(adc_reference_micro_volts)));
+  }
+};
+
 template <int32_t kAdcBits, int32_t kThermistorMicroVolts,
           int32_t kFixedMicroVolts, int32_t kAdcReferenceMicroVolts,
           int32_t kFixedResistor, int32_t kT0Celsius, int32_t kBFactor,
           int32_t kR0>
 inline constexpr int32_t TemperatureToAdcTwoNodeThermistor(
     const double kelvin) {
-  const auto r_inf = Utilities::TemperatureCalculator::Calculate_r_inf(
-      kR0, kBFactor, kT0Celsius);
-  assert(r_inf > 0);
-  const auto thermistor_resistance =
-      Utilities::TemperatureCalculator::ResistanceFromTemperature(
-          kelvin, kBFactor, r_inf);
-  const auto thermistor_resistance_rounded =
-      Utilities::round<decltype(thermistor_resistance), int64_t>(
-          thermistor_resistance);
-  const auto thermistor_resistance_int =
-      Utilities::StaticCastQuickFail<int64_t>(thermistor_resistance_rounded);
-  assert(thermistor_resistance_int > 0);
-  const auto node_micro_volts =
-      Calculator::TwoNodeVoltageDivider<int64_t>(
-          static_cast<int64_t>(kThermistorMicroVolts),
-          static_cast<int64_t>(kFixedMicroVolts),
-          thermistor_resistance_int,
-          static_cast<int64_t>(kFixedResistor));
-  const int32_t adc_value = Calculator::ScaleToDigitalValue<int64_t>(
-      node_micro_volts, static_cast<int>(kAdcBits),
-      int64_t{0}, static_cast<int64_t>(kAdcReferenceMicroVolts));
-  //  assert(adc_value < (1<<kAdcBits));
-  return adc_value;
+  return TwoNodeThermistor{kAdcBits,       kThermistorMicroVolts,
+                           kFixedMicroVolts, kAdcReferenceMicroVolts,
+                           kFixedResistor, kT0Celsius,
+                           kBFactor,       kR0}(kelvin);
+}
+
+/*
+ * Temperature change per adc count from point to next, rounded
+ * */
+inline constexpr int32_t CalculateSlopeBetweenPoints(
+    const InterpolatedTemperatureLine& point,
+    const InterpolatedTemperatureLine& next) {
+  const double adc_reading = point.adc_reading;
+  const double next_adc_reading = next.adc_reading;
+  const double tdiff = next.t0 - point.t0;
+  const auto slope = Utilities::round<decltype(tdiff), int32_t>(
+      (tdiff) / (next_adc_reading - adc_reading));
+  return Utilities::StaticCastQuickFail<int32_t>(slope);
 }
 
 //  todo need to do something to handle different temps being the same adc value
@@ -78,15 +112,8 @@ class TemperatureTableMaker {
   static constexpr void SetSlopeBetweenPoints(
       std::array<InterpolatedTemperatureLine, kNumPoints>* arr) {
     for (std::size_t i = 0; i < arr->size() - 1; i++) {
-      const double adc_reading = arr->at(i).adc_reading;
-      const double next_adc_reading = arr->at(i + 1).adc_reading;
-      const double tdiff = arr->at(i + 1).t0 - arr->at(i).t0;
-      const auto slope = Utilities::round<decltype(tdiff), int32_t>(
-          (tdiff) / (next_adc_reading - adc_reading));
-      const auto rounded_slope = Utilities::StaticCastQuickFail<int32_t>(slope);
-      const auto tdiff_calc = (next_adc_reading - adc_reading) * rounded_slope;
-
-      arr->at(i).DeltaTByDeltaADCSlope = rounded_slope;
+      arr->at(i).DeltaTByDeltaADCSlope =
+          CalculateSlopeBetweenPoints(arr->at(i), arr->at(i + 1));
     }
     //  last point has same slope as preceeding one
     arr->at(arr->size() - 1).DeltaTByDeltaADCSlope =
@@ -119,41 +146,121 @@ class TemperatureTableMaker {
 class ThermistorDividerBase {
   // protected:
  public:
+  /*
+   * Number of entries in [begin, end) whose reading is at or above
+   * adc_reading plus begin. The table is decreasing in adc so this is the
+   * index of the first reading below adc_reading. Branch free binary search,
+   * the compare only selects the next base.
+   * */
+  static constexpr std::size_t CountReadingsAtOrAbove(
+      const int32_t adc_reading, const InterpolatedTemperatureLine* const table,
+      const std::size_t begin, const std::size_t end) {
+    if (begin == end) {
+      return begin;
+    }
+    const InterpolatedTemperatureLine* base = table + begin;
+    std::size_t length = end - begin;
+    while (length > 1) {
+      const std::size_t half = length / 2;
+      base = (base[half - 1].adc_reading >= adc_reading) ? base + half : base;
+      length -= half;
+    }
+    return static_cast<std::size_t>(base - table) +
+           (base->adc_reading >= adc_reading ? 1 : 0);
+  }
+
+  /*
+   * First entry with a reading below index, the last entry if there is none
+   * */
   static constexpr std::size_t FindMatchingIndexLower(
       const std::size_t index, const InterpolatedTemperatureLine* const table,
       const std::size_t array_size) {
-    const int32_t adc_reading = static_cast<int32_t>(index);
-    for (std::size_t i = 0; i < array_size; i++) {
-      if (table[i].adc_reading < adc_reading) {  //  table is decreasing in adc
-        return i;
-      }
-    }
-    //  assert(i < kTable.size());//out of range
-    return array_size - 1;
+    return FindMatchingIndexLower(index, table, array_size, 0, array_size);
   }
 
+  /*
+   * Entry with the reading closest to index, on a tie the later entry
+   * */
   static constexpr std::size_t FindClosestMatchingIndex(
       const std::size_t index, const InterpolatedTemperatureLine* const table,
       const std::size_t array_size) {
+    return FindClosestMatchingIndex(index, table, array_size, 0, array_size);
+  }
+
+  /*
+   * Entry starting the segment index falls in, the last entry reading at or
+   * above index. InterpolatePoint from it follows the segment slope all the
+   * way to the next entry where the closest entry would pin the far half of
+   * the segment to the next entry's temperature.
+   * */
+  static constexpr std::size_t FindSegmentIndex(
+      const std::size_t index, const InterpolatedTemperatureLine* const table,
+      const std::size_t array_size) {
+    assert(array_size > 0);
+    const std::size_t above = CountReadingsAtOrAbove(
+        static_cast<int32_t>(index), table, 0, array_size);
+    return above ? above - 1 : 0;
+  }
+
+  /*
+   * As above with the search narrowed by an AdcIndexBuckets table
+   * */
+  template <typename Buckets>
+  static constexpr std::size_t FindMatchingIndexLower(
+      const std::size_t index, const InterpolatedTemperatureLine* const table,
+      const std::size_t array_size, const Buckets& buckets) {
+    return FindMatchingIndexLower(index, table, array_size,
+                                  buckets.GetBegin(index),
+                                  buckets.GetEnd(index));
+  }
+
+  template <typename Buckets>
+  static constexpr std::size_t FindClosestMatchingIndex(
+      const std::size_t index, const InterpolatedTemperatureLine* const table,
+      const std::size_t array_size, const Buckets& buckets) {
+    return FindClosestMatchingIndex(index, table, array_size,
+                                    buckets.GetBegin(index),
+                                    buckets.GetEnd(index));
+  }
+
+  /*
+   * The first entry below index is searched for in [begin, end), entries
+   * before begin must read at or above index and entries from end on below
+   * */
+  static constexpr std::size_t FindMatchingIndexLower(
+      const std::size_t index, const InterpolatedTemperatureLine* const table,
+      const std::size_t array_size, const std::size_t begin,
+      const std::size_t end) {
+    assert(array_size > 0);
+    const int32_t adc_reading = static_cast<int32_t>(index);
+    const std::size_t above =
+        CountReadingsAtOrAbove(adc_reading, table, begin, end);
+    return above < array_size ? above : array_size - 1;
+  }
+
+  static constexpr std::size_t FindClosestMatchingIndex(
+      const std::size_t index, const InterpolatedTemperatureLine* const table,
+      const std::size_t array_size, const std::size_t begin,
+      const std::size_t end) {
+    assert(array_size > 0);
     const int32_t adc_reading = static_cast<int32_t>(index);
-    int32_t last_error = std::numeric_limits<int32_t>::max();
-    std::size_t i = 0;
-    for (i = 0; i < array_size; i++) {
-      const int32_t err = table[i].adc_reading > adc_reading
-                              ? table[i].adc_reading - adc_reading
-                              : adc_reading - table[i].adc_reading;
-      if (err > last_error) {
-        if (i) {
-          return i - 1;
-        } else {
-          return 0;
-        }
+    //  the error falls until the readings pass adc_reading then rises
+    const std::size_t above =
+        CountReadingsAtOrAbove(adc_reading, table, begin, end);
+    if (above == array_size) {
+      return array_size - 1;
+    }
+    if (above > 0) {
+      const int32_t error_above = table[above - 1].adc_reading - adc_reading;
+      const int32_t error_below = adc_reading - table[above].adc_reading;
+      if (error_below > error_above) {
+        return above - 1;
       }
-      last_error = err;
     }
-    //  assert(i < kTable.size());//out of range
-    assert(i == array_size);
-    return array_size - 1;
+    //  last of a run of equal readings
+    return CountReadingsAtOrAbove(table[above].adc_reading, table, above,
+                                  array_size) -
+           1;
   }
 
   static constexpr int32_t InterpolatePoint(
@@ -166,6 +273,321 @@ class ThermistorDividerBase {
     //  pin the value to the next known point if higher
     return gain_calc < pt_close.t0 ? pt_close.t0 : gain_calc;
   }
+
+  /*
+   * InterpolatePoint over count readings. Each block first finds the
+   * closest entry of every reading, then gathers the entries into columns
+   * so the interpolation is a separate multiply, add and clamp loop.
+   * lookup(i, adc_reading) returns the entry for reading i.
+   * */
+  template <typename Input, typename Lookup>
+  static void InterpolateReadings(const Input* const adc_readings,
+                                  const std::size_t count, int32_t* const out,
+                                  const Lookup& lookup) {
+    const constexpr std::size_t kBlockSize = 64;
+    std::array<int32_t, kBlockSize> reading{};
+    std::array<int32_t, kBlockSize> line_reading{};
+    std::array<int32_t, kBlockSize> t0{};
+    std::array<int32_t, kBlockSize> slope{};
+    for (std::size_t offset = 0; offset < count; offset += kBlockSize) {
+      const std::size_t block = count - offset < kBlockSize ? count - offset
+                                                            : kBlockSize;
+      for (std::size_t i = 0; i < block; i++) {
+        reading[i] = static_cast<int32_t>(adc_readings[offset + i]);
+        const InterpolatedTemperatureLine& line =
+            lookup(offset + i, reading[i]);
+        line_reading[i] = line.adc_reading;
+        t0[i] = line.t0;
+        slope[i] = line.DeltaTByDeltaADCSlope;
+      }
+      for (std::size_t i = 0; i < block; i++) {
+        const int32_t value = slope[i] * (reading[i] - line_reading[i]) + t0[i];
+        out[offset + i] = value < t0[i] ? t0[i] : value;
+      }
+    }
+  }
+
+  /*
+   * Micro degrees of count readings all converted with the same table
+   * */
+  template <typename Input>
+  static void InterpolatePoints(const Input* const adc_readings,
+                                const std::size_t count,
+                                const InterpolatedTemperatureLine* const table,
+                                const std::size_t array_size,
+                                int32_t* const out) {
+    InterpolateReadings(
+        adc_readings, count, out,
+        [table, array_size](std::size_t, const int32_t adc_reading)
+            -> const InterpolatedTemperatureLine& {
+          return table[FindClosestMatchingIndex(
+              static_cast<std::size_t>(adc_reading), table, array_size)];
+        });
+  }
+
+  template <typename Input, typename Buckets>
+  static void InterpolatePoints(const Input* const adc_readings,
+                                const std::size_t count,
+                                const InterpolatedTemperatureLine* const table,
+                                const std::size_t array_size,
+                                const Buckets& buckets, int32_t* const out) {
+    InterpolateReadings(
+        adc_readings, count, out,
+        [table, array_size, &buckets](std::size_t, const int32_t adc_reading)
+            -> const InterpolatedTemperatureLine& {
+          return table[FindClosestMatchingIndex(
+              static_cast<std::size_t>(adc_reading), table, array_size,
+              buckets)];
+        });
+  }
+
+  /*
+   * Reading i is converted with tables[i] of array_sizes[i] entries, for a
+   * scan of channels with different sensors or pull ups
+   * */
+  template <typename Input>
+  static void InterpolateChannels(
+      const Input* const adc_readings, const std::size_t count,
+      const InterpolatedTemperatureLine* const* const tables,
+      const std::size_t* const array_sizes, int32_t* const out) {
+    InterpolateReadings(
+        adc_readings, count, out,
+        [tables, array_sizes](const std::size_t channel,
+                              const int32_t adc_reading)
+            -> const InterpolatedTemperatureLine& {
+          return tables[channel][FindClosestMatchingIndex(
+              static_cast<std::size_t>(adc_reading), tables[channel],
+              array_sizes[channel])];
+        });
+  }
+};
+
+/*
+ * Coarse direct index on the top kBucketBits of a kAdcBits code. Each bucket
+ * holds the range of table entries its codes can land on so the binary
+ * search only covers a few entries whatever the table size.
+ * */
+template <std::size_t kAdcBits, std::size_t kBucketBits>
+class AdcIndexBuckets {
+  static_assert(kBucketBits > 0 && kBucketBits <= kAdcBits,
+                "Bucket bits must be between 1 and the adc bits");
+  static const constexpr std::size_t kShift = kAdcBits - kBucketBits;
+  static const constexpr std::size_t kBuckets = std::size_t{1} << kBucketBits;
+
+  //  entries reading at or above the first code of each bucket
+  std::array<std::size_t, kBuckets + 1> boundaries_{};
+
+ public:
+  static constexpr std::size_t GetBucketCount(void) { return kBuckets; }
+
+  constexpr std::size_t GetBegin(const std::size_t index) const {
+    assert(index < (std::size_t{1} << kAdcBits));
+    return boundaries_[(index >> kShift) + 1];
+  }
+  constexpr std::size_t GetEnd(const std::size_t index) const {
+    assert(index < (std::size_t{1} << kAdcBits));
+    return boundaries_[index >> kShift];
+  }
+
+  constexpr AdcIndexBuckets(const InterpolatedTemperatureLine* const table,
+                            const std::size_t array_size) {
+    for (std::size_t bucket = 0; bucket <= kBuckets; bucket++) {
+      boundaries_[bucket] = ThermistorDividerBase::CountReadingsAtOrAbove(
+          static_cast<int32_t>(bucket << kShift), table, 0, array_size);
+    }
+  }
+};
+
+/*
+ * Table from AdaptiveTemperatureTableMaker, the first size entries are used
+ * */
+template <std::size_t kMaxPoints>
+struct AdaptiveTemperatureTable {
+  std::array<InterpolatedTemperatureLine, kMaxPoints> table{};
+  std::size_t size = 0;
+  //  largest error over the sampled temperatures in micro celsius
+  int32_t max_error = 0;
+
+  constexpr const InterpolatedTemperatureLine* data(void) const {
+    return table.data();
+  }
+};
+
+/*
+ * Places the table points where the curve needs them instead of evenly in
+ * temperature. The range is sampled at kSamples temperatures and each
+ * segment is stretched over as many samples as it can while the
+ * interpolated temperature of every sample it covers stays within the
+ * target error. The error is measured through FindSegmentIndex and
+ * InterpolatePoint so it is what a lookup will see, ADC quantization
+ * included. If kMaxPoints runs out the last point is placed at the end of
+ * the range and max_error reports what was achieved.
+ *
+ * The points stay on the curve and the ADC quantization error is the same
+ * for any table, so the saving is bounded. For the 12 bit divider with a
+ * 10k NTC in the tests, -30 to 50 C, 23 points match the error of a 64
+ * point even table.
+ * */
+template <int32_t kTCelsiusStart, int32_t kTCelsiusEnd, uint32_t kMaxPoints,
+          typename F, uint32_t kSamples = 1024>
+class AdaptiveTemperatureTableMaker {
+  static_assert(kTCelsiusStart < kTCelsiusEnd, "Not increasing");
+  static_assert(kMaxPoints >= 2, "Need at least two points");
+  static_assert(kSamples >= kMaxPoints, "Fewer samples than points");
+
+  struct Sample {
+    int32_t adc_reading = 0;
+    int32_t t0 = 0;
+  };
+  using Samples = std::array<Sample, kSamples>;
+
+  static constexpr Samples MakeSamples(F TemperatureToAdc) {
+    Samples samples{};
+    for (std::size_t i = 0; i < kSamples; i++) {
+      const double t = kTCelsiusStart + static_cast<double>(i) *
+                                            (kTCelsiusEnd - kTCelsiusStart) /
+                                            (kSamples - 1);
+      const auto adc_reading = TemperatureToAdc(Utilities::CelsiusToKelvin(t));
+      assert(adc_reading >= 0);
+      samples[i].adc_reading =
+          Utilities::StaticCastQuickFail<int32_t>(adc_reading);
+      samples[i].t0 = Utilities::StaticCastQuickFail<int32_t>(
+          Utilities::round<double, int32_t>(
+              Calculator::TranslateToMicro<double>(t)));
+    }
+    return samples;
+  }
+
+  static constexpr InterpolatedTemperatureLine MakeLine(const Sample& sample) {
+    return InterpolatedTemperatureLine{sample.adc_reading, sample.t0, 0};
+  }
+
+  static constexpr int32_t GetError(
+      const Sample& sample, const InterpolatedTemperatureLine* const table,
+      const std::size_t array_size) {
+    const std::size_t index = ThermistorDividerBase::FindSegmentIndex(
+        static_cast<std::size_t>(sample.adc_reading), table, array_size);
+    const int32_t t =
+        ThermistorDividerBase::InterpolatePoint(sample.adc_reading,
+                                                table[index]);
+    return t > sample.t0 ? t - sample.t0 : sample.t0 - t;
+  }
+
+  static constexpr int32_t GetMaxError(
+      const Samples& samples, const InterpolatedTemperatureLine* const table,
+      const std::size_t array_size, const std::size_t first,
+      const std::size_t last) {
+    int32_t max_error = 0;
+    for (std::size_t i = first; i <= last; i++) {
+      const int32_t error = GetError(samples[i], table, array_size);
+      max_error = error > max_error ? error : max_error;
+    }
+    return max_error;
+  }
+
+  //  error of the samples from first to last with a table of just their ends
+  static constexpr int32_t GetSegmentError(const Samples& samples,
+                                           const std::size_t first,
+                                           const std::size_t last) {
+    std::array<InterpolatedTemperatureLine, 2> segment{
+        MakeLine(samples[first]), MakeLine(samples[last])};
+    segment[0].DeltaTByDeltaADCSlope =
+        CalculateSlopeBetweenPoints(segment[0], segment[1]);
+    segment[1].DeltaTByDeltaADCSlope = segment[0].DeltaTByDeltaADCSlope;
+    return GetMaxError(samples, segment.data(), segment.size(), first, last);
+  }
+
+  //  first sample with a lower reading, kSamples if there is none. Equal
+  //  readings can not be told apart so they share a segment.
+  static constexpr std::size_t FindNextReading(const Samples& samples,
+                                               const std::size_t first) {
+    std::size_t next = first + 1;
+    while (next < kSamples &&
+           samples[next].adc_reading >= samples[first].adc_reading) {
+      next++;
+    }
+    return next;
+  }
+
+  /*
+   * Furthest sample the segment from first can reach within max_error, first
+   * if no sample has a lower reading. The segment grows in doubling steps
+   * until it fails then the end is found by bisection, so each knot costs
+   * O(n log n) sample evaluations instead of O(n^2).
+   * */
+  static constexpr std::size_t FindSegmentEnd(const Samples& samples,
+                                              const std::size_t first,
+                                              const int32_t max_error) {
+    std::size_t last = FindNextReading(samples, first);
+    if (last == kSamples) {
+      return first;
+    }
+    //  the nearest lower reading is always taken so the table advances
+    std::size_t failed = kSamples;
+    for (std::size_t step = 1; last + 1 < kSamples; step *= 2) {
+      const std::size_t probe =
+          kSamples - 1 - last < step ? kSamples - 1 : last + step;
+      if (GetSegmentError(samples, first, probe) > max_error) {
+        failed = probe;
+        break;
+      }
+      last = probe;
+    }
+    while (failed - last > 1 && failed < kSamples) {
+      const std::size_t middle = last + (failed - last) / 2;
+      if (GetSegmentError(samples, first, middle) > max_error) {
+        failed = middle;
+      } else {
+        last = middle;
+      }
+    }
+    return last;
+  }
+
+ public:
+  static constexpr AdaptiveTemperatureTable<kMaxPoints> GetTable(
+      F TemperatureToAdc, const int32_t max_error_micro_celsius) {
+    const Samples samples = MakeSamples(TemperatureToAdc);
+    AdaptiveTemperatureTable<kMaxPoints> out{};
+    std::size_t first = 0;
+    out.table[out.size++] = MakeLine(samples[first]);
+    while (out.size < kMaxPoints) {
+      std::size_t last =
+          FindSegmentEnd(samples, first, max_error_micro_celsius);
+      if (last == first) {
+        break;  //  no lower readings left
+      }
+      if (out.size + 1 == kMaxPoints) {
+        //  out of points, close the table at the end of the range
+        last = kSamples - 1;
+      }
+      out.table[out.size++] = MakeLine(samples[last]);
+      first = last;
+    }
+    for (std::size_t i = 0; i + 1 < out.size; i++) {
+      out.table[i].DeltaTByDeltaADCSlope =
+          CalculateSlopeBetweenPoints(out.table[i], out.table[i + 1]);
+    }
+    //  last point has same slope as preceeding one
+    if (out.size > 1) {
+      out.table[out.size - 1].DeltaTByDeltaADCSlope =
+          out.table[out.size - 2].DeltaTByDeltaADCSlope;
+    }
+    out.max_error =
+        GetMaxError(samples, out.data(), out.size, 0, kSamples - 1);
+    return out;
+  }
+
+  /*
+   * Error of any table against the same samples, to compare with an evenly
+   * spaced TemperatureTableMaker table
+   * */
+  static constexpr int32_t GetMaxError(
+      F TemperatureToAdc, const InterpolatedTemperatureLine* const table,
+      const std::size_t array_size) {
+    return GetMaxError(MakeSamples(TemperatureToAdc), table, array_size, 0,
+                       kSamples - 1);
+  }
 };
 
 }  //  namespace TemperatureMeasurement
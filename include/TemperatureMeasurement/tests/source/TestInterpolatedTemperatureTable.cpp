@@ -0,0 +1,77 @@
+/*
+ * Copyright 2020 Electrooptical Innovations
+ * */
+
+#include <TemperatureMeasurement/InterpolatedTemperatureTable.h>
+#include <TemperatureMeasurement/ThermistorDivider.h>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+
+namespace {
+using TemperatureMeasurement::InterpolatedTemperatureLine;
+using TemperatureMeasurement::ThermistorDividerBase;
+
+const constexpr auto kTemperatureToAdc =
+    TemperatureMeasurement::TemperatureToAdcTwoNodeThermistor<
+        12, 0, 3300000, 3300000, 17400, 25, 4000, 10000>;
+
+const auto kTable = TemperatureMeasurement::TemperatureTableMaker<
+    -30, 50, 64, decltype(kTemperatureToAdc)>::GetTable(kTemperatureToAdc);
+
+//  decreasing readings with runs of equal values
+std::array<InterpolatedTemperatureLine, 500> MakeRepeatingTable(void) {
+  std::array<InterpolatedTemperatureLine, 500> table{};
+  int32_t reading = 4000;
+  for (std::size_t i = 0; i < table.size(); i++) {
+    table[i] = {reading, static_cast<int32_t>(i) * 1000, -7};
+    reading -= (i % 7 == 0) ? 0 : static_cast<int32_t>(i % 3) * 3 + 1;
+  }
+  return table;
+}
+
+template <typename KeyType, std::size_t kNumPoints>
+void CheckMatchesBase(
+    const std::array<InterpolatedTemperatureLine, kNumPoints>& table) {
+  const TemperatureMeasurement::InterpolatedTemperatureTable<kNumPoints,
+                                                             KeyType>
+      columns{table};
+  for (std::size_t code = 0; code < 4096; code++) {
+    const std::size_t closest = ThermistorDividerBase::FindClosestMatchingIndex(
+        code, table.data(), table.size());
+    ASSERT_EQ(ThermistorDividerBase::FindMatchingIndexLower(
+                  code, table.data(), table.size()),
+              columns.FindMatchingIndexLower(code))
+        << code;
+    ASSERT_EQ(closest, columns.FindClosestMatchingIndex(code)) << code;
+    ASSERT_EQ(ThermistorDividerBase::InterpolatePoint(
+                  static_cast<int32_t>(code), table[closest]),
+              columns.GetMicroCelsius(code))
+        << code;
+  }
+}
+}  // namespace
+
+TEST(InterpolatedTemperatureTable, MatchesThermistorDividerBase) {
+  CheckMatchesBase<int32_t>(kTable);
+  CheckMatchesBase<int16_t>(kTable);
+  CheckMatchesBase<uint16_t>(kTable);
+  const auto repeating = MakeRepeatingTable();
+  CheckMatchesBase<int32_t>(repeating);
+  CheckMatchesBase<int16_t>(repeating);
+}
+
+TEST(InterpolatedTemperatureTable, Columns) {
+  using Table =
+      TemperatureMeasurement::InterpolatedTemperatureTable<64, int16_t>;
+  const Table columns{kTable};
+  static_assert(Table::GetKeyFootprint() == 64 * sizeof(int16_t));
+  static_assert(Table::GetFootprint() == 64 * 10);
+  for (std::size_t i = 0; i < kTable.size(); i++) {
+    const auto line = columns.GetLine(i);
+    EXPECT_EQ(kTable[i].adc_reading, line.adc_reading);
+    EXPECT_EQ(kTable[i].t0, line.t0);
+    EXPECT_EQ(kTable[i].DeltaTByDeltaADCSlope, line.DeltaTByDeltaADCSlope);
+  }
+}
@@ -0,0 +1,187 @@
+/*
+ * Copyright 2020 Electrooptical Innovations
+ * */
+
+#include <TemperatureMeasurement/RuntimeTemperatureTable.h>
+#include <TemperatureMeasurement/ThermistorDivider.h>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace {
+using TemperatureMeasurement::InterpolatedTemperatureLine;
+using TemperatureMeasurement::RuntimeTemperatureTable;
+using TemperatureMeasurement::TwoNodeThermistor;
+
+const constexpr std::size_t kNumPoints = 64;
+
+const constexpr auto kTemperatureToAdc =
+    TemperatureMeasurement::TemperatureToAdcTwoNodeThermistor<
+        12, 0, 3300000, 3300000, 17400, 25, 4000, 10000>;
+const constexpr auto kRecalibratedToAdc =
+    TemperatureMeasurement::TemperatureToAdcTwoNodeThermistor<
+        12, 0, 3300000, 3300000, 17400, 25, 3950, 10000>;
+
+const constexpr TwoNodeThermistor kThermistor{12,    0,  3300000, 3300000,
+                                              17400, 25, 4000,    10000};
+const constexpr TwoNodeThermistor kRecalibrated{12,    0,  3300000, 3300000,
+                                                17400, 25, 3950,    10000};
+
+const auto kTable = TemperatureMeasurement::TemperatureTableMaker<
+    -30, 50, kNumPoints,
+    decltype(kTemperatureToAdc)>::GetTable(kTemperatureToAdc);
+const auto kRecalibratedTable = TemperatureMeasurement::TemperatureTableMaker<
+    -30, 50, kNumPoints,
+    decltype(kRecalibratedToAdc)>::GetTable(kRecalibratedToAdc);
+
+bool Equal(const InterpolatedTemperatureLine& a,
+           const InterpolatedTemperatureLine& b) {
+  return a.adc_reading == b.adc_reading && a.t0 == b.t0 &&
+         a.DeltaTByDeltaADCSlope == b.DeltaTByDeltaADCSlope;
+}
+
+template <std::size_t kSize>
+bool Matches(const InterpolatedTemperatureLine* const table,
+             const std::array<InterpolatedTemperatureLine, kSize>& expected) {
+  for (std::size_t i = 0; i < kSize; i++) {
+    if (!Equal(table[i], expected[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <std::size_t kSize>
+std::array<InterpolatedTemperatureLine, kSize> Copy(
+    const RuntimeTemperatureTable<kSize>& runtime) {
+  std::array<InterpolatedTemperatureLine, kSize> table{};
+  runtime.Read([&table](const InterpolatedTemperatureLine* const lines,
+                        const std::size_t size) {
+    for (std::size_t i = 0; i < size; i++) {
+      table[i] = lines[i];
+    }
+  });
+  return table;
+}
+}  //  namespace
+
+TEST(RuntimeTemperatureTable, TwoNodeThermistorMatchesTemplate) {
+  static_assert(kThermistor(298.15) == kTemperatureToAdc(298.15));
+  for (double kelvin = 240; kelvin < 330; kelvin += 0.25) {
+    EXPECT_EQ(kThermistor(kelvin), kTemperatureToAdc(kelvin));
+  }
+}
+
+TEST(RuntimeTemperatureTable, MatchesTableMaker) {
+  RuntimeTemperatureTable<kNumPoints> runtime{-30, 50, kThermistor};
+  EXPECT_TRUE(Matches(Copy(runtime).data(), kTable));
+  EXPECT_EQ(runtime.GetGeneration(), 0u);
+  EXPECT_DOUBLE_EQ(runtime.GetPointCelsius(0), -30);
+  EXPECT_DOUBLE_EQ(runtime.GetPointCelsius(kNumPoints - 1), 50);
+
+  runtime.Rebuild(kRecalibrated);
+  EXPECT_TRUE(Matches(Copy(runtime).data(), kRecalibratedTable));
+  EXPECT_EQ(runtime.GetGeneration(), 1u);
+
+  for (std::size_t code = 0; code < 4096; code += 7) {
+    const std::size_t index =
+        TemperatureMeasurement::ThermistorDividerBase::FindClosestMatchingIndex(
+            code, kRecalibratedTable.data(), kRecalibratedTable.size());
+    EXPECT_EQ(runtime.GetMicroCelsius(code),
+              TemperatureMeasurement::ThermistorDividerBase::InterpolatePoint(
+                  static_cast<int32_t>(code), kRecalibratedTable[index]));
+  }
+}
+
+TEST(RuntimeTemperatureTable, RefitChangesOnlyTheRange) {
+  const std::size_t kFirst = 20;
+  const std::size_t kCount = 10;
+  RuntimeTemperatureTable<kNumPoints> runtime{-30, 50, kThermistor};
+  runtime.Refit(kRecalibrated, kFirst, kCount);
+  const auto table = Copy(runtime);
+  for (std::size_t i = 0; i < kNumPoints; i++) {
+    const bool refit = i >= kFirst && i < kFirst + kCount;
+    const auto& expected = refit ? kRecalibratedTable[i] : kTable[i];
+    EXPECT_EQ(table[i].adc_reading, expected.adc_reading) << i;
+    EXPECT_EQ(table[i].t0, expected.t0) << i;
+    //  the segments into and out of the range join the two calibrations
+    if (i + 1 != kFirst && i + 1 != kFirst + kCount) {
+      EXPECT_EQ(table[i].DeltaTByDeltaADCSlope,
+                expected.DeltaTByDeltaADCSlope)
+          << i;
+    }
+  }
+
+  //  refitting everything is the same as a rebuild
+  runtime.Refit(kRecalibrated, 0, kNumPoints);
+  EXPECT_TRUE(Matches(Copy(runtime).data(), kRecalibratedTable));
+}
+
+TEST(RuntimeTemperatureTable, RejectsEqualReadings) {
+  using WriteResult = RuntimeTemperatureTable<kNumPoints>::WriteResult;
+  RuntimeTemperatureTable<kNumPoints> runtime{-30, 50, kThermistor};
+  //  an adc that saturates puts the hot end points on one reading
+  const auto saturated = [](const double kelvin) {
+    const int32_t reading = kRecalibrated(kelvin);
+    return reading < 1000 ? 1000 : reading;
+  };
+  EXPECT_TRUE(runtime.Refit(saturated, 40, 24) == WriteResult::kEqualReadings);
+  EXPECT_TRUE(runtime.Rebuild(saturated) == WriteResult::kEqualReadings);
+  EXPECT_TRUE(Matches(Copy(runtime).data(), kTable));
+  EXPECT_EQ(runtime.GetGeneration(), 0u);
+  //  the part of the range above the saturation still refits
+  EXPECT_TRUE(runtime.Refit(saturated, 0, 20) == WriteResult::kPublished);
+  EXPECT_EQ(runtime.GetGeneration(), 1u);
+}
+
+TEST(RuntimeTemperatureTable, TryRebuildWithReaderOnOldCopy) {
+  using WriteResult = RuntimeTemperatureTable<kNumPoints>::WriteResult;
+  RuntimeTemperatureTable<kNumPoints> runtime{-30, 50, kThermistor};
+  runtime.Read([&runtime](const InterpolatedTemperatureLine* const table,
+                          std::size_t) {
+    //  the copy being read is not written, the swap leaves it held
+    EXPECT_TRUE(runtime.TryRebuild(kRecalibrated) == WriteResult::kPublished);
+    EXPECT_TRUE(runtime.TryRebuild(kThermistor) == WriteResult::kReadersBusy);
+    EXPECT_TRUE(runtime.TryRefit(kThermistor, 0, 1) ==
+                WriteResult::kReadersBusy);
+    EXPECT_TRUE(Matches(table, kTable));
+  });
+  EXPECT_TRUE(Matches(Copy(runtime).data(), kRecalibratedTable));
+  EXPECT_TRUE(runtime.TryRebuild(kThermistor) == WriteResult::kPublished);
+  EXPECT_TRUE(Matches(Copy(runtime).data(), kTable));
+}
+
+TEST(RuntimeTemperatureTable, ReadersSeeCompleteTables) {
+  RuntimeTemperatureTable<kNumPoints> runtime{-30, 50, kThermistor};
+  std::atomic<bool> done{false};
+  std::atomic<uint32_t> torn{0};
+  std::atomic<uint32_t> reads{0};
+  std::vector<std::thread> readers;
+  for (int thread = 0; thread < 3; thread++) {
+    readers.emplace_back([&]() {
+      while (!done.load()) {
+        const bool complete = runtime.Read(
+            [](const InterpolatedTemperatureLine* const table, std::size_t) {
+              return Matches(table, kTable) ||
+                     Matches(table, kRecalibratedTable);
+            });
+        torn.fetch_add(complete ? 0 : 1);
+        reads.fetch_add(1);
+      }
+    });
+  }
+  for (int i = 0; i < 2000; i++) {
+    runtime.Rebuild(i % 2 ? kThermistor : kRecalibrated);
+  }
+  done.store(true);
+  for (auto& thread : readers) {
+    thread.join();
+  }
+  EXPECT_EQ(torn.load(), 0u);
+  EXPECT_GT(reads.load(), 0u);
+  EXPECT_EQ(runtime.GetGeneration(), 2000u);
+}
@@ -8,6 +8,8 @@
 
 #include <cstdio>
 #include <iostream>
+#include <limits>
+#include <vector>
 
 class Thermistor : public TemperatureMeasurement::ThermistorDividerBase {
  public:
@@ -34,10 +36,7 @@ class Thermistor : public TemperatureMeasurement::ThermistorDividerBase {
           kAdcReferenceMicroVolts, kRPullup, kT0Celsius, kBFactor, kR0>;
 
  public:
-  // Table is computed at runtime on non-clang compilers (std::exp is not
-  // constexpr before C++23). The firmware static_asserts verify compile-time
-  // correctness on the target toolchain.
-  inline static const auto kTable =
+  static constexpr auto kTable =
       TemperatureMeasurement::TemperatureTableMaker<
           kTemperatureStart, kTemperatureEnd, kNumPoints,
           decltype(temperature_to_adc)>::GetTable(temperature_to_adc);
@@ -55,6 +54,10 @@ class Thermistor : public TemperatureMeasurement::ThermistorDividerBase {
 };
 
 
+//  the table is built during compilation
+static_assert(Thermistor::kTable[0].t0 == -30000000);
+static_assert(Thermistor::kTable[Thermistor::kNumPoints - 1].t0 == 50000000);
+
 #if 0
 TEST(TableValues) {
   Thermistor cont{};
@@ -153,3 +156,211 @@ TEST(Thermistor, InterpolatedTemperatureIncreasesByIndex) {
   }
 }
 #endif
+
+namespace {
+using TemperatureMeasurement::InterpolatedTemperatureLine;
+
+//  linear scans the binary searches replaced
+std::size_t LinearMatchingIndexLower(const std::size_t index,
+                                     const InterpolatedTemperatureLine* table,
+                                     const std::size_t array_size) {
+  const int32_t adc_reading = static_cast<int32_t>(index);
+  for (std::size_t i = 0; i < array_size; i++) {
+    if (table[i].adc_reading < adc_reading) {
+      return i;
+    }
+  }
+  return array_size - 1;
+}
+
+std::size_t LinearClosestMatchingIndex(const std::size_t index,
+                                       const InterpolatedTemperatureLine* table,
+                                       const std::size_t array_size) {
+  const int32_t adc_reading = static_cast<int32_t>(index);
+  int32_t last_error = std::numeric_limits<int32_t>::max();
+  for (std::size_t i = 0; i < array_size; i++) {
+    const int32_t err = table[i].adc_reading > adc_reading
+                            ? table[i].adc_reading - adc_reading
+                            : adc_reading - table[i].adc_reading;
+    if (err > last_error) {
+      return i ? i - 1 : 0;
+    }
+    last_error = err;
+  }
+  return array_size - 1;
+}
+
+template <typename Buckets>
+void CheckMatchesLinear(const std::vector<InterpolatedTemperatureLine>& table,
+                        const std::size_t code_count,
+                        const Buckets& buckets) {
+  using Base = TemperatureMeasurement::ThermistorDividerBase;
+  for (std::size_t code = 0; code < code_count; code++) {
+    const std::size_t lower =
+        LinearMatchingIndexLower(code, table.data(), table.size());
+    const std::size_t closest =
+        LinearClosestMatchingIndex(code, table.data(), table.size());
+    ASSERT_EQ(lower,
+              Base::FindMatchingIndexLower(code, table.data(), table.size()))
+        << code;
+    ASSERT_EQ(closest, Base::FindClosestMatchingIndex(code, table.data(),
+                                                      table.size()))
+        << code;
+    ASSERT_EQ(lower, Base::FindMatchingIndexLower(code, table.data(),
+                                                  table.size(), buckets))
+        << code;
+    ASSERT_EQ(closest, Base::FindClosestMatchingIndex(code, table.data(),
+                                                      table.size(), buckets))
+        << code;
+  }
+}
+}  // namespace
+
+TEST(Thermistor, SearchMatchesLinearScan) {
+  const std::vector<InterpolatedTemperatureLine> table(
+      Thermistor::kTable.begin(), Thermistor::kTable.end());
+  const TemperatureMeasurement::AdcIndexBuckets<Thermistor::kADCBits, 6>
+      buckets{table.data(), table.size()};
+  CheckMatchesLinear(table, std::size_t{1} << Thermistor::kADCBits, buckets);
+}
+
+TEST(Thermistor, SearchLargeTableWithRepeats) {
+  //  500 decreasing readings with runs of equal values and uneven steps
+  std::vector<InterpolatedTemperatureLine> table;
+  int32_t reading = 4000;
+  for (int32_t i = 0; i < 500; i++) {
+    table.push_back({reading, i, -1});
+    reading -= (i % 7 == 0) ? 0 : (i % 3) * 3 + 1;
+  }
+  ASSERT_GE(table.back().adc_reading, 0);
+  for (std::size_t size : {std::size_t{1}, std::size_t{2}, std::size_t{3},
+                           std::size_t{100}, table.size()}) {
+    const std::vector<InterpolatedTemperatureLine> part(table.begin(),
+                                                       table.begin() + size);
+    const TemperatureMeasurement::AdcIndexBuckets<12, 8> buckets{part.data(),
+                                                                 part.size()};
+    CheckMatchesLinear(part, 4096, buckets);
+  }
+}
+
+TEST(Thermistor, InterpolatePointsMatchesSingle) {
+  const std::size_t kCodes = std::size_t{1} << Thermistor::kADCBits;
+  std::vector<uint32_t> readings(kCodes + 13);
+  for (std::size_t i = 0; i < readings.size(); i++) {
+    readings[i] = static_cast<uint32_t>((i * 2654435761u) % kCodes);
+  }
+  std::vector<int32_t> out(readings.size());
+  Thermistor::InterpolatePoints(readings.data(), readings.size(),
+                                Thermistor::kTable.data(),
+                                Thermistor::kTable.size(), out.data());
+  const TemperatureMeasurement::AdcIndexBuckets<Thermistor::kADCBits, 6>
+      buckets{Thermistor::kTable.data(), Thermistor::kTable.size()};
+  std::vector<int32_t> bucket_out(readings.size());
+  Thermistor::InterpolatePoints(readings.data(), readings.size(),
+                                Thermistor::kTable.data(),
+                                Thermistor::kTable.size(), buckets,
+                                bucket_out.data());
+  for (std::size_t i = 0; i < readings.size(); i++) {
+    const int32_t expected =
+        Thermistor::GetMicroCelsiusFromAdcReading(readings[i]);
+    ASSERT_EQ(expected, out[i]) << i;
+    ASSERT_EQ(expected, bucket_out[i]) << i;
+  }
+}
+
+TEST(Thermistor, InterpolateChannels) {
+  //  every other channel has a 10k pull up
+  const auto other_table = TemperatureMeasurement::TemperatureTableMaker<
+      Thermistor::kTemperatureStart, Thermistor::kTemperatureEnd, 32,
+      int32_t (*)(double)>::
+      GetTable(TemperatureMeasurement::TemperatureToAdcTwoNodeThermistor<
+               Thermistor::kADCBits, 0, 3300000, 3300000, 10000, 25, 4000,
+               10000>);
+  const std::size_t kChannels = 128;
+  std::vector<const InterpolatedTemperatureLine*> tables(kChannels);
+  std::vector<std::size_t> sizes(kChannels);
+  std::vector<int32_t> readings(kChannels);
+  for (std::size_t channel = 0; channel < kChannels; channel++) {
+    const bool other = channel % 2;
+    tables[channel] = other ? other_table.data() : Thermistor::kTable.data();
+    sizes[channel] = other ? other_table.size() : Thermistor::kTable.size();
+    readings[channel] = static_cast<int32_t>(channel * 31);
+  }
+  std::vector<int32_t> out(kChannels);
+  Thermistor::InterpolateChannels(readings.data(), kChannels, tables.data(),
+                                  sizes.data(), out.data());
+  for (std::size_t channel = 0; channel < kChannels; channel++) {
+    const std::size_t reading = static_cast<std::size_t>(readings[channel]);
+    const std::size_t index = Thermistor::FindClosestMatchingIndex(
+        reading, tables[channel], sizes[channel]);
+    EXPECT_EQ(Thermistor::InterpolatePoint(readings[channel],
+                                           tables[channel][index]),
+              out[channel]);
+  }
+}
+
+namespace {
+using AdaptiveMaker = TemperatureMeasurement::AdaptiveTemperatureTableMaker<
+    Thermistor::kTemperatureStart, Thermistor::kTemperatureEnd, 64,
+    decltype(Thermistor::temperature_to_adc)>;
+}  // namespace
+
+//  both the error of the even table and the adaptive table are compile time
+constexpr int32_t kUniformError = AdaptiveMaker::GetMaxError(
+    Thermistor::temperature_to_adc, Thermistor::kTable.data(),
+    Thermistor::kTable.size());
+constexpr auto kAdaptiveTable =
+    AdaptiveMaker::GetTable(Thermistor::temperature_to_adc, kUniformError);
+static_assert(kAdaptiveTable.max_error <= kUniformError);
+//  23 points against 64, the test asserts at least 2.5x fewer
+static_assert(kAdaptiveTable.size * 5 <= Thermistor::kTable.size() * 2);
+static_assert(kAdaptiveTable.table[0].t0 == Thermistor::kTable.front().t0);
+
+TEST(Thermistor, AdaptiveTableMeetsUniformErrorWithFewerPoints) {
+  const int32_t uniform_error = AdaptiveMaker::GetMaxError(
+      Thermistor::temperature_to_adc, Thermistor::kTable.data(),
+      Thermistor::kTable.size());
+  const auto adaptive =
+      AdaptiveMaker::GetTable(Thermistor::temperature_to_adc, uniform_error);
+  EXPECT_LE(adaptive.max_error, uniform_error);
+  EXPECT_LE(adaptive.size * 2, Thermistor::kTable.size());
+  EXPECT_EQ(adaptive.max_error,
+            AdaptiveMaker::GetMaxError(Thermistor::temperature_to_adc,
+                                       adaptive.data(), adaptive.size));
+  for (std::size_t i = 1; i < adaptive.size; i++) {
+    EXPECT_LT(adaptive.table[i].adc_reading, adaptive.table[i - 1].adc_reading);
+    EXPECT_GT(adaptive.table[i].t0, adaptive.table[i - 1].t0);
+    EXPECT_LT(adaptive.table[i].DeltaTByDeltaADCSlope, 0);
+  }
+  EXPECT_EQ(Thermistor::kTable.front().t0, adaptive.table[0].t0);
+  EXPECT_EQ(Thermistor::kTable.back().t0,
+            adaptive.table[adaptive.size - 1].t0);
+}
+
+TEST(Thermistor, AdaptiveTableOutOfPoints) {
+  using SmallMaker = TemperatureMeasurement::AdaptiveTemperatureTableMaker<
+      Thermistor::kTemperatureStart, Thermistor::kTemperatureEnd, 4,
+      decltype(Thermistor::temperature_to_adc)>;
+  const auto adaptive = SmallMaker::GetTable(Thermistor::temperature_to_adc, 1);
+  EXPECT_EQ(4, adaptive.size);
+  EXPECT_GT(adaptive.max_error, 1);
+  EXPECT_EQ(Thermistor::kTable.back().t0, adaptive.table[3].t0);
+}
+
+TEST(Thermistor, FindSegmentIndex) {
+  const auto& table = Thermistor::kTable;
+  for (std::size_t i = 0; i < table.size(); i++) {
+    const auto reading = static_cast<std::size_t>(table[i].adc_reading);
+    EXPECT_EQ(i, Thermistor::FindSegmentIndex(reading, table.data(),
+                                              table.size()));
+    if (i + 1 < table.size()) {
+      //  the whole segment interpolates from its upper entry
+      EXPECT_EQ(i, Thermistor::FindSegmentIndex(
+                       static_cast<std::size_t>(table[i + 1].adc_reading + 1),
+                       table.data(), table.size()));
+    }
+  }
+  EXPECT_EQ(0, Thermistor::FindSegmentIndex(4095, table.data(), table.size()));
+  EXPECT_EQ(table.size() - 1,
+            Thermistor::FindSegmentIndex(0, table.data(), table.size()));
+}
@@ -0,0 +1,278 @@
+/*
+ * Copyright 2020 ElectroOptical Innovations, LLC
+ *
+ * Pack and unpack N bit ADC samples. Samples are either packed tightly into
+ * a bit stream or right justified in the smallest whole number of bytes
+ * (e.g. 18 bit samples in 3 byte words). Unpacking sign extends in the same
+ * pass when the output type is signed.
+ * */
+#pragma once
+#ifndef UTILITIES_BITPACKING_H_
+#define UTILITIES_BITPACKING_H_
+
+#include <Utilities/TypeConversion.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
+
+namespace Utilities {
+enum class SamplePacking {
+  kTight,  //  samples follow each other with no padding bits
+  kWord,   //  each sample is right justified in CalcNumberOfBytesToFitBits
+};
+
+/*
+ * Sign extend the low kBits of value, bits above kBits are ignored
+ * */
+template <std::size_t kBits, typename T = int32_t>
+inline constexpr T SignExtendBits(const uint32_t value) {
+  static_assert(kBits > 0 && kBits <= 32);
+  const uint32_t sign_bit = uint32_t{1} << (kBits - 1);
+  const uint32_t mask = kBits == 32 ? ~uint32_t{0} : (sign_bit << 1) - 1;
+  const uint32_t masked = value & mask;
+  //  (x ^ sign) - sign extends without relying on arithmetic shifts, the
+  //  subtraction is unsigned so 32 bit values can not overflow
+  return static_cast<T>(static_cast<int32_t>((masked ^ sign_bit) - sign_bit));
+}
+
+static_assert(SignExtendBits<12>(0xfff) == -1);
+static_assert(SignExtendBits<12>(0x7ff) == 2047);
+static_assert(SignExtendBits<12>(0x800) == -2048);
+static_assert(SignExtendBits<24>(0xff800000) == -8388608);
+static_assert(SignExtendBits<32>(0x80000000) == -2147483647 - 1);
+
+template <std::size_t kBits, ByteOrder kOrder = ByteOrder::kLsbFirst,
+          SamplePacking kPacking = SamplePacking::kTight>
+class PackedSamples {
+  static_assert(kBits > 0 && kBits <= 32, "Sample width must be 1-32 bits");
+  static constexpr uint32_t kMask =
+      kBits == 32 ? ~uint32_t{0} : (uint32_t{1} << kBits) - 1;
+  static constexpr std::size_t kWordBytes = CalcNumberOfBytesToFitBits(kBits);
+  //  bytes touched by one tightly packed sample with any bit alignment
+  static constexpr std::size_t kWindowBytes = (kBits + 7 + 7) / 8;
+
+  static constexpr uint64_t LoadWindow(const uint8_t* const data,
+                                       const std::size_t bytes) {
+    uint64_t window = 0;
+    for (std::size_t i = 0; i < bytes; i++) {
+      if (kOrder == ByteOrder::kLsbFirst) {
+        window |= static_cast<uint64_t>(data[i]) << (8 * i);
+      } else {
+        window |= static_cast<uint64_t>(data[i])
+                  << (8 * (kWindowBytes - 1 - i));
+      }
+    }
+    return window;
+  }
+
+  static constexpr uint32_t ExtractTight(const uint64_t window,
+                                         const std::size_t shift) {
+    if (kOrder == ByteOrder::kLsbFirst) {
+      return static_cast<uint32_t>(window >> shift) & kMask;
+    }
+    return static_cast<uint32_t>(window >> (8 * kWindowBytes - shift - kBits)) &
+           kMask;
+  }
+
+  template <typename T>
+  static constexpr T Convert(const uint32_t raw) {
+    if constexpr (std::is_signed<T>::value) {
+      return SignExtendBits<kBits, T>(raw);
+    } else {
+      return static_cast<T>(raw);
+    }
+  }
+
+ public:
+  static constexpr std::size_t kBitsPerSample = kBits;
+
+  /*
+   * Bytes needed to hold count samples
+   * */
+  static constexpr std::size_t GetPackedSize(const std::size_t count) {
+    if (kPacking == SamplePacking::kWord) {
+      return count * kWordBytes;
+    }
+    return CalcNumberOfBytesToFitBits(count * kBits);
+  }
+
+  /*
+   * Decode up to count samples from data_length bytes, returns the number of
+   * samples written
+   * */
+  template <typename T>
+  static std::size_t Unpack(const uint8_t* const data,
+                            const std::size_t data_length, T* const samples,
+                            std::size_t count) {
+    static_assert(std::is_integral<T>());
+    static_assert(kBits <= 8 * sizeof(T), "Output type too narrow");
+    if (kPacking == SamplePacking::kWord) {
+      count = std::min(count, data_length / kWordBytes);
+      for (std::size_t i = 0; i < count; i++) {
+        uint32_t raw = 0;
+        for (std::size_t byte = 0; byte < kWordBytes; byte++) {
+          const std::size_t position =
+              kOrder == ByteOrder::kLsbFirst ? byte : kWordBytes - 1 - byte;
+          raw |= static_cast<uint32_t>(data[i * kWordBytes + position])
+                 << (8 * byte);
+        }
+        samples[i] = Convert<T>(raw);
+      }
+      return count;
+    }
+
+    count = std::min(count, (data_length * 8) / kBits);
+    //  samples whose whole window is inside the buffer take the fixed length
+    //  load, the compiler turns it into one wide load and shift
+    std::size_t fast_count = 0;
+    if (data_length >= kWindowBytes) {
+      fast_count =
+          std::min(count, ((data_length - kWindowBytes) * 8) / kBits + 1);
+    }
+    for (std::size_t i = 0; i < fast_count; i++) {
+      const std::size_t bit = i * kBits;
+      const uint64_t window = LoadWindow(&data[bit / 8], kWindowBytes);
+      samples[i] = Convert<T>(ExtractTight(window, bit % 8));
+    }
+    for (std::size_t i = fast_count; i < count; i++) {
+      const std::size_t bit = i * kBits;
+      const std::size_t available =
+          std::min(kWindowBytes, data_length - bit / 8);
+      const uint64_t window = LoadWindow(&data[bit / 8], available);
+      samples[i] = Convert<T>(ExtractTight(window, bit % 8));
+    }
+    return count;
+  }
+
+  /*
+   * Encode count samples, only the low kBits of each sample are kept. Returns
+   * the bytes written or 0 if data_length is too short.
+   * */
+  template <typename T>
+  static std::size_t Pack(const T* const samples, const std::size_t count,
+                          uint8_t* const data, const std::size_t data_length) {
+    static_assert(std::is_integral<T>());
+    const std::size_t packed_size = GetPackedSize(count);
+    if (data_length < packed_size) {
+      return 0;
+    }
+    if (kPacking == SamplePacking::kWord) {
+      for (std::size_t i = 0; i < count; i++) {
+        const uint32_t raw = static_cast<uint32_t>(samples[i]) & kMask;
+        for (std::size_t byte = 0; byte < kWordBytes; byte++) {
+          const std::size_t position =
+              kOrder == ByteOrder::kLsbFirst ? byte : kWordBytes - 1 - byte;
+          data[i * kWordBytes + position] =
+              static_cast<uint8_t>(0xff & (raw >> (8 * byte)));
+        }
+      }
+      return packed_size;
+    }
+
+    uint64_t accumulator = 0;
+    std::size_t accumulated_bits = 0;
+    std::size_t byte = 0;
+    for (std::size_t i = 0; i < count; i++) {
+      const uint64_t raw = static_cast<uint32_t>(samples[i]) & kMask;
+      if (kOrder == ByteOrder::kLsbFirst) {
+        accumulator |= raw << accumulated_bits;
+        accumulated_bits += kBits;
+        for (; accumulated_bits >= 8; accumulated_bits -= 8) {
+          data[byte++] = static_cast<uint8_t>(accumulator & 0xff);
+          accumulator >>= 8;
+        }
+      } else {
+        accumulator = (accumulator << kBits) | raw;
+        accumulated_bits += kBits;
+        for (; accumulated_bits >= 8; accumulated_bits -= 8) {
+          data[byte++] = static_cast<uint8_t>(
+              0xff & (accumulator >> (accumulated_bits - 8)));
+        }
+      }
+    }
+    if (accumulated_bits) {
+      if (kOrder == ByteOrder::kLsbFirst) {
+        data[byte++] = static_cast<uint8_t>(accumulator & 0xff);
+      } else {
+        data[byte++] = static_cast<uint8_t>(
+            0xff & (accumulator << (8 - accumulated_bits)));
+      }
+    }
+    assert(byte == packed_size);
+    return packed_size;
+  }
+};
+
+/*
+ * Pack count values of a runtime width (0-32 bits) LSB first into a bit
+ * stream, bits above the width are dropped. data must hold
+ * CalcNumberOfBytesToFitBits(count * bits) bytes, which is returned.
+ * */
+inline std::size_t PackBits(const uint32_t* const values,
+                            const std::size_t count, const std::size_t bits,
+                            uint8_t* const data) {
+  assert(bits <= 32);
+  const uint64_t mask = (uint64_t{1} << bits) - 1;
+  uint64_t accumulator = 0;
+  std::size_t accumulated_bits = 0;
+  std::size_t byte = 0;
+  for (std::size_t i = 0; i < count; i++) {
+    accumulator |= (values[i] & mask) << accumulated_bits;
+    accumulated_bits += bits;
+    if (accumulated_bits >= 32) {
+      StoreInteger<ByteOrder::kLsbFirst, uint32_t>(
+          static_cast<uint32_t>(accumulator), &data[byte]);
+      byte += sizeof(uint32_t);
+      accumulator >>= 32;
+      accumulated_bits -= 32;
+    }
+  }
+  while (accumulated_bits > 0) {
+    data[byte++] = static_cast<uint8_t>(accumulator & 0xff);
+    accumulator >>= 8;
+    accumulated_bits = accumulated_bits > 8 ? accumulated_bits - 8 : 0;
+  }
+  return byte;
+}
+
+/*
+ * Inverse of PackBits, returns the number of values decoded
+ * */
+inline std::size_t UnpackBits(const uint8_t* const data,
+                              const std::size_t data_length,
+                              const std::size_t bits, uint32_t* const values,
+                              std::size_t count) {
+  assert(bits <= 32);
+  if (bits == 0) {
+    std::fill(values, values + count, 0);
+    return count;
+  }
+  count = std::min(count, (data_length * 8) / bits);
+  const uint64_t mask = (uint64_t{1} << bits) - 1;
+  std::size_t fast_count = 0;
+  if (data_length >= sizeof(uint64_t)) {
+    fast_count =
+        std::min(count, ((data_length - sizeof(uint64_t)) * 8) / bits + 1);
+  }
+  for (std::size_t i = 0; i < fast_count; i++) {
+    const std::size_t bit = i * bits;
+    const auto window =
+        LoadInteger<ByteOrder::kLsbFirst, uint64_t>(&data[bit / 8]);
+    values[i] = static_cast<uint32_t>((window >> (bit % 8)) & mask);
+  }
+  for (std::size_t i = fast_count; i < count; i++) {
+    const std::size_t bit = i * bits;
+    uint64_t window = 0;
+    for (std::size_t byte = bit / 8, shift = 0;
+         byte < data_length && shift < 64; byte++, shift += 8) {
+      window |= static_cast<uint64_t>(data[byte]) << shift;
+    }
+    values[i] = static_cast<uint32_t>((window >> (bit % 8)) & mask);
+  }
+  return count;
+}
+}  //  namespace Utilities
+
+#endif  //  UTILITIES_BITPACKING_H_
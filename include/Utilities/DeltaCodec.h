@@ -0,0 +1,218 @@
+/*
+ * Copyright 2020 ElectroOptical Innovations, LLC
+ *
+ * Block codec for slowly varying sample streams such as raw ADC captures.
+ * Each block of up to kBlockSize samples is stored as:
+ *   first sample (sizeof(T) bytes, LSB first)
+ *   delta bit width (1 byte)
+ *   (count - 1) zigzag encoded deltas bit packed with PackBits
+ * Blocks are independent so any block can be decoded given its offset.
+ * */
+#pragma once
+#ifndef UTILITIES_DELTACODEC_H_
+#define UTILITIES_DELTACODEC_H_
+
+#include <Utilities/BitPacking.h>
+#include <Utilities/TypeConversion.h>
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
+
+namespace Utilities {
+template <typename T = int16_t, std::size_t kBlockSize = 128>
+class DeltaBlockCodec {
+  static_assert(std::is_integral<T>() && sizeof(T) <= sizeof(uint32_t),
+                "Samples must be integers of at most 32 bits");
+  static_assert(kBlockSize > 1);
+  using Unsigned = std::make_unsigned_t<T>;
+  using Signed = std::make_signed_t<T>;
+  static constexpr std::size_t kValueBits = 8 * sizeof(T);
+
+  static constexpr std::size_t BitWidth(uint32_t value) {
+    std::size_t bits = 0;
+    for (; value; value >>= 1) {
+      bits++;
+    }
+    return bits;
+  }
+
+ public:
+  static constexpr std::size_t kHeaderSize = sizeof(T) + 1;
+  static constexpr std::size_t kMaxEncodedBlockSize =
+      kHeaderSize + CalcNumberOfBytesToFitBits((kBlockSize - 1) * kValueBits);
+
+  static constexpr std::size_t GetBlockCount(const std::size_t count) {
+    return (count + kBlockSize - 1) / kBlockSize;
+  }
+
+  static constexpr std::size_t GetBlockSampleCount(
+      const std::size_t block_index, const std::size_t count) {
+    const std::size_t start = block_index * kBlockSize;
+    return start >= count ? 0 : std::min(kBlockSize, count - start);
+  }
+
+  static constexpr std::size_t GetEncodedBlockSize(const std::size_t bits,
+                                                   const std::size_t count) {
+    return kHeaderSize + CalcNumberOfBytesToFitBits((count - 1) * bits);
+  }
+
+  /*
+   * Encode 1 to kBlockSize samples, returns the bytes written or 0 if
+   * data_length is too short
+   * */
+  static std::size_t EncodeBlock(const T* const samples,
+                                 const std::size_t count, uint8_t* const data,
+                                 const std::size_t data_length) {
+    assert(count > 0 && count <= kBlockSize);
+    std::array<uint32_t, kBlockSize - 1> deltas;
+    uint32_t used_bits = 0;
+    //  deltas wrap in the sample width so every delta fits in kValueBits
+    for (std::size_t i = 1; i < count; i++) {
+      const auto delta = static_cast<Unsigned>(
+          static_cast<Unsigned>(samples[i]) -
+          static_cast<Unsigned>(samples[i - 1]));
+      deltas[i - 1] = ZigZagEncode<Signed>(static_cast<Signed>(delta));
+      used_bits |= deltas[i - 1];
+    }
+    const std::size_t bits = BitWidth(used_bits);
+    const std::size_t size = GetEncodedBlockSize(bits, count);
+    if (data_length < size) {
+      return 0;
+    }
+    StoreInteger<ByteOrder::kLsbFirst, Unsigned>(
+        static_cast<Unsigned>(samples[0]), data);
+    data[sizeof(T)] = static_cast<uint8_t>(bits);
+    PackBits(deltas.data(), count - 1, bits, &data[kHeaderSize]);
+    return size;
+  }
+
+  /*
+   * Decode a block of count samples, returns the bytes consumed or 0 if the
+   * block is malformed or truncated
+   * */
+  static std::size_t DecodeBlock(const uint8_t* const data,
+                                 const std::size_t data_length,
+                                 T* const samples, const std::size_t count) {
+    assert(count > 0 && count <= kBlockSize);
+    if (data_length < kHeaderSize) {
+      return 0;
+    }
+    const std::size_t bits = data[sizeof(T)];
+    if (bits > kValueBits) {
+      return 0;
+    }
+    const std::size_t size = GetEncodedBlockSize(bits, count);
+    if (data_length < size) {
+      return 0;
+    }
+    std::array<uint32_t, kBlockSize - 1> deltas;
+    UnpackBits(&data[kHeaderSize], size - kHeaderSize, bits, deltas.data(),
+               count - 1);
+    auto value = LoadInteger<ByteOrder::kLsbFirst, Unsigned>(data);
+    samples[0] = static_cast<T>(value);
+    for (std::size_t i = 1; i < count; i++) {
+      const auto delta =
+          ZigZagDecode<Unsigned>(static_cast<Unsigned>(deltas[i - 1]));
+      value = static_cast<Unsigned>(value + static_cast<Unsigned>(delta));
+      samples[i] = static_cast<T>(value);
+    }
+    return size;
+  }
+
+  /*
+   * Encode a whole capture. If block_offsets is given it receives the byte
+   * offset of each of the GetBlockCount(count) blocks for random access.
+   * Returns the bytes written or 0 if data_length is too short.
+   * */
+  static std::size_t Encode(const T* const samples, const std::size_t count,
+                            uint8_t* const data, const std::size_t data_length,
+                            uint32_t* const block_offsets = nullptr) {
+    std::size_t offset = 0;
+    for (std::size_t block = 0; block < GetBlockCount(count); block++) {
+      if (block_offsets) {
+        block_offsets[block] = static_cast<uint32_t>(offset);
+      }
+      const std::size_t written = EncodeBlock(
+          &samples[block * kBlockSize], GetBlockSampleCount(block, count),
+          &data[offset], data_length - offset);
+      if (written == 0) {
+        return 0;
+      }
+      offset += written;
+    }
+    return offset;
+  }
+
+  /*
+   * Decode count samples written by Encode, returns the samples decoded
+   * */
+  static std::size_t Decode(const uint8_t* const data,
+                            const std::size_t data_length, T* const samples,
+                            const std::size_t count) {
+    std::size_t offset = 0;
+    for (std::size_t block = 0; block < GetBlockCount(count); block++) {
+      const std::size_t consumed = DecodeBlock(
+          &data[offset], data_length - offset, &samples[block * kBlockSize],
+          GetBlockSampleCount(block, count));
+      if (consumed == 0) {
+        return block * kBlockSize;
+      }
+      offset += consumed;
+    }
+    return count;
+  }
+
+  /*
+   * Decode only block block_index of a capture of count samples using the
+   * offsets recorded by Encode, returns the samples decoded
+   * */
+  static std::size_t DecodeBlockAt(const uint8_t* const data,
+                                   const std::size_t data_length,
+                                   const uint32_t* const block_offsets,
+                                   const std::size_t block_index,
+                                   const std::size_t count, T* const samples) {
+    const std::size_t block_count = GetBlockSampleCount(block_index, count);
+    //  a block past the end has no offset to read
+    if (block_count == 0) {
+      return 0;
+    }
+    const std::size_t offset = block_offsets[block_index];
+    if (offset >= data_length) {
+      return 0;
+    }
+    return DecodeBlock(&data[offset], data_length - offset, samples,
+                       block_count)
+               ? block_count
+               : 0;
+  }
+
+  /*
+   * Streaming encoder, pops whole blocks from a ring buffer (anything with
+   * GetCount and pop(T*, count)) while there is room for a worst case block.
+   * With flush set a trailing partial block is encoded as well. Returns the
+   * bytes written.
+   * */
+  template <typename Ring>
+  static std::size_t EncodeFromBuffer(Ring* const ring, uint8_t* const data,
+                                      const std::size_t data_length,
+                                      const bool flush = false) {
+    std::array<T, kBlockSize> block;
+    std::size_t offset = 0;
+    while (data_length - offset >= kMaxEncodedBlockSize) {
+      const std::size_t available = ring->GetCount();
+      if (available == 0 || (available < kBlockSize && !flush)) {
+        break;
+      }
+      const std::size_t popped =
+          ring->pop(block.data(), std::min(available, kBlockSize));
+      offset += EncodeBlock(block.data(), popped, &data[offset],
+                            data_length - offset);
+    }
+    return offset;
+  }
+};
+}  //  namespace Utilities
+
+#endif  //  UTILITIES_DELTACODEC_H_
@@ -0,0 +1,161 @@
+/*
+ * Copyright 2020 ElectroOptical Innovations, LLC
+ *
+ * Division by a divisor that is fixed for many dividends, replaced with a
+ * multiply high and two shifts (Granlund & Montgomery, "Division by
+ * Invariant Integers using Multiplication", figure 4.1) for 32 and 64 bit
+ * signed and unsigned types. Results are exactly n / d for every n.
+ *
+ *   l  = ceil(log2(d))
+ *   m' = floor(2^N * (2^l - d) / d) + 1
+ *   t1 = mulhi(m', n)
+ *   q  = (t1 + ((n - t1) >> min(l, 1))) >> max(l - 1, 0)
+ * */
+#pragma once
+#ifndef UTILITIES_INVARIANTDIVISOR_H_
+#define UTILITIES_INVARIANTDIVISOR_H_
+
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
+
+namespace Utilities {
+namespace InvariantDivision {
+/*
+ * High 64 bits of the 128 bit product
+ * */
+inline constexpr uint64_t MultiplyHigh(const uint64_t a, const uint64_t b) {
+#ifdef __SIZEOF_INT128__
+  __extension__ using Wide = unsigned __int128;
+  return static_cast<uint64_t>((Wide{a} * b) >> 64);
+#else
+  const uint64_t a_low = a & 0xffffffff;
+  const uint64_t a_high = a >> 32;
+  const uint64_t b_low = b & 0xffffffff;
+  const uint64_t b_high = b >> 32;
+  const uint64_t low_low = a_low * b_low;
+  const uint64_t high_low = a_high * b_low;
+  const uint64_t low_high = a_low * b_high;
+  const uint64_t middle =
+      (low_low >> 32) + (high_low & 0xffffffff) + (low_high & 0xffffffff);
+  return a_high * b_high + (high_low >> 32) + (low_high >> 32) + (middle >> 32);
+#endif
+}
+
+/*
+ * (high:low) / divisor for high < divisor, bit at a time long division so it
+ * works in constexpr and on targets without a 128 bit type. Only used when
+ * preparing a divisor.
+ * */
+inline constexpr uint64_t DivideWide(const uint64_t high, const uint64_t low,
+                                     const uint64_t divisor) {
+  assert(high < divisor);
+  uint64_t remainder = high;
+  uint64_t quotient = 0;
+  for (int bit = 63; bit >= 0; bit--) {
+    const bool carry = (remainder >> 63) != 0;
+    remainder = (remainder << 1) | ((low >> bit) & 1);
+    quotient <<= 1;
+    if (carry || remainder >= divisor) {
+      remainder -= divisor;
+      quotient |= 1;
+    }
+  }
+  return quotient;
+}
+
+inline constexpr unsigned CeilLog2(const uint64_t value) {
+  unsigned bits = 0;
+  while (bits < 64 && (uint64_t{1} << bits) < value) {
+    bits++;
+  }
+  return bits;
+}
+}  //  namespace InvariantDivision
+
+/*
+ * Signed division truncates toward zero like the / operator, it divides the
+ * magnitudes and restores the sign with a branch free xor and subtract
+ * */
+template <typename T = uint64_t>
+class InvariantDivisor {
+  static_assert(std::is_integral<T>() &&
+                    (sizeof(T) == sizeof(uint32_t) ||
+                     sizeof(T) == sizeof(uint64_t)),
+                "Only 32 and 64 bit integers are supported");
+  using Unsigned = std::make_unsigned_t<T>;
+  static constexpr unsigned kBits = 8 * sizeof(T);
+
+  Unsigned multiplier_ = 0;
+  unsigned shift_1_ = 0;
+  unsigned shift_2_ = 0;
+  Unsigned divisor_sign_ = 0;  //  all ones for a negative divisor
+  T divisor_ = 1;
+
+  static constexpr Unsigned MultiplyHigh(const Unsigned a, const Unsigned b) {
+    if constexpr (kBits == 32) {
+      return static_cast<Unsigned>((uint64_t{a} * b) >> 32);
+    } else {
+      return InvariantDivision::MultiplyHigh(a, b);
+    }
+  }
+
+  constexpr Unsigned DivideUnsigned(const Unsigned dividend) const {
+    const Unsigned t1 = MultiplyHigh(multiplier_, dividend);
+    return static_cast<Unsigned>(
+        (t1 + static_cast<Unsigned>((dividend - t1) >> shift_1_)) >> shift_2_);
+  }
+
+ public:
+  constexpr T GetDivisor(void) const { return divisor_; }
+
+  constexpr T divide(const T dividend) const {
+    if constexpr (std::is_signed<T>::value) {
+      const auto sign = static_cast<Unsigned>(0 - Unsigned{dividend < 0});
+      const auto magnitude = static_cast<Unsigned>(
+          (static_cast<Unsigned>(dividend) ^ sign) - sign);
+      const Unsigned result_sign = sign ^ divisor_sign_;
+      return static_cast<T>(
+          (DivideUnsigned(magnitude) ^ result_sign) - result_sign);
+    } else {
+      return DivideUnsigned(dividend);
+    }
+  }
+
+  //  divides by 1
+  constexpr InvariantDivisor(void) {}
+  explicit constexpr InvariantDivisor(const T divisor) : divisor_{divisor} {
+    assert(divisor != 0);
+    Unsigned magnitude = static_cast<Unsigned>(divisor);
+    if constexpr (std::is_signed<T>::value) {
+      divisor_sign_ = static_cast<Unsigned>(0 - Unsigned{divisor < 0});
+      magnitude = static_cast<Unsigned>((magnitude ^ divisor_sign_) -
+                                        divisor_sign_);
+    }
+    const unsigned l = InvariantDivision::CeilLog2(magnitude);
+    //  2^l - d, 2^N - d when l is N
+    const auto excess = static_cast<Unsigned>(
+        l == kBits ? 0 - magnitude : (Unsigned{1} << l) - magnitude);
+    if constexpr (kBits == 32) {
+      multiplier_ =
+          static_cast<Unsigned>(((uint64_t{excess} << 32) / magnitude) + 1);
+    } else {
+      multiplier_ = InvariantDivision::DivideWide(excess, 0, magnitude) + 1;
+    }
+    shift_1_ = l < 1 ? l : 1;
+    shift_2_ = l > 1 ? l - 1 : 0;
+  }
+};
+
+static_assert(InvariantDivisor<>(7).divide(100) == 14);
+static_assert(InvariantDivisor<>(1).divide(~uint64_t{0}) == ~uint64_t{0});
+static_assert(InvariantDivisor<>(~uint64_t{0}).divide(~uint64_t{0}) == 1);
+static_assert(InvariantDivisor<>(uint64_t{1} << 63).divide(~uint64_t{0}) == 1);
+static_assert(InvariantDivisor<uint32_t>(3).divide(0xffffffff) == 0x55555555);
+static_assert(InvariantDivisor<int32_t>(-7).divide(100) == -14);
+static_assert(InvariantDivisor<int64_t>(7).divide(-100) == -14);
+static_assert(InvariantDivisor<int64_t>(-7).divide(-100) == 14);
+static_assert(InvariantDivisor<int32_t>().divide(-100) == -100);
+}  //  namespace Utilities
+
+#endif  //  UTILITIES_INVARIANTDIVISOR_H_
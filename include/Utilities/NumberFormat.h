@@ -0,0 +1,189 @@
+/*
+ * Copyright 2020 ElectroOptical Innovations, LLC
+ *
+ * Integer to text conversion using a two digit lookup table, one divide by
+ * 100 per pair of digits. Nothing is null terminated, every function returns
+ * the number of characters written.
+ * */
+#pragma once
+#ifndef UTILITIES_NUMBERFORMAT_H_
+#define UTILITIES_NUMBERFORMAT_H_
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace Utilities {
+namespace NumberFormat {
+inline constexpr char kDigitPairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+template <typename T>
+inline constexpr std::size_t CountDigits(T value) {
+  std::size_t digits = 1;
+  for (;;) {
+    //  four digits per iteration keeps the loop short for large values
+    if (value < 10) return digits;
+    if (value < 100) return digits + 1;
+    if (value < 1000) return digits + 2;
+    if (value < 10000) return digits + 3;
+    value /= 10000;
+    digits += 4;
+  }
+}
+
+/*
+ * Write exactly digits digits of value ending at out[digits - 1], higher
+ * digits are dropped and missing ones are zero filled
+ * */
+template <typename T>
+inline void WriteDigits(T value, char* const out, std::size_t digits) {
+  while (digits >= 2) {
+    const auto pair = static_cast<std::size_t>(value % 100);
+    value /= 100;
+    digits -= 2;
+    out[digits] = kDigitPairs[2 * pair];
+    out[digits + 1] = kDigitPairs[2 * pair + 1];
+  }
+  if (digits) {
+    out[0] = static_cast<char>('0' + static_cast<char>(value % 10));
+  }
+}
+
+//  values of 32 bits or less are formatted with 32 bit divides
+template <typename T>
+using UnsignedWork =
+    std::conditional_t<(sizeof(T) <= sizeof(uint32_t)), uint32_t, uint64_t>;
+}  //  namespace NumberFormat
+
+/*
+ * Largest number of characters FormatDecimal writes for type T
+ * */
+template <typename T>
+inline constexpr std::size_t kMaxDecimalChars =
+    std::numeric_limits<T>::digits10 + 1 + (std::is_signed<T>::value ? 1 : 0);
+
+/*
+ * Write value in decimal, returns the characters written (at most
+ * kMaxDecimalChars<T>)
+ * */
+template <typename T>
+inline std::size_t FormatDecimal(const T value, char* const out) {
+  static_assert(std::is_integral<T>());
+  using Work = NumberFormat::UnsignedWork<T>;
+  std::size_t sign = 0;
+  Work magnitude = static_cast<Work>(value);
+  if constexpr (std::is_signed<T>::value) {
+    if (value < 0) {
+      out[0] = '-';
+      sign = 1;
+      //  negate in the unsigned type so the minimum value is handled
+      magnitude = static_cast<Work>(0 - static_cast<Work>(value));
+    }
+  }
+  const std::size_t digits = NumberFormat::CountDigits(magnitude);
+  NumberFormat::WriteDigits(magnitude, &out[sign], digits);
+  return sign + digits;
+}
+
+/*
+ * Write the low width digits of value zero padded
+ * */
+template <typename T>
+inline std::size_t FormatFixedWidth(const T value, char* const out,
+                                    const std::size_t width) {
+  static_assert(std::is_unsigned<T>());
+  NumberFormat::WriteDigits(static_cast<NumberFormat::UnsignedWork<T>>(value),
+                            out, width);
+  return width;
+}
+
+/*
+ * Largest number of characters FormatMicro writes
+ * */
+const constexpr std::size_t kMaxMicroChars = kMaxDecimalChars<int64_t> + 1;
+
+/*
+ * Write a value scaled by TranslateToMicro as a fixed point decimal with six
+ * fractional digits, 25000000 -> "25.000000"
+ * */
+template <typename T>
+inline std::size_t FormatMicro(const T micro, char* const out) {
+  static_assert(std::is_integral<T>());
+  const constexpr uint64_t kMicroScaleFactor = 1'000'000;
+  const constexpr std::size_t kFractionDigits = 6;
+  std::size_t length = 0;
+  uint64_t magnitude = static_cast<uint64_t>(micro);
+  if constexpr (std::is_signed<T>::value) {
+    if (micro < 0) {
+      out[length++] = '-';
+      magnitude = 0 - static_cast<uint64_t>(micro);
+    }
+  }
+  length += FormatDecimal(magnitude / kMicroScaleFactor, &out[length]);
+  out[length++] = '.';
+  length += FormatFixedWidth(magnitude % kMicroScaleFactor, &out[length],
+                             kFractionDigits);
+  return length;
+}
+
+namespace NumberFormat {
+template <typename T, typename Formatter>
+inline std::size_t FormatArray(const T* const values, const std::size_t count,
+                               const char delimiter, char* const out,
+                               const std::size_t out_length,
+                               const std::size_t max_chars,
+                               const Formatter& format) {
+  std::size_t length = 0;
+  for (std::size_t i = 0; i < count; i++) {
+    //  one worst case check per value instead of per character
+    const std::size_t needed = max_chars + (i ? 1 : 0);
+    if (out_length - length < needed) {
+      break;
+    }
+    if (i) {
+      out[length++] = delimiter;
+    }
+    length += format(values[i], &out[length]);
+  }
+  return length;
+}
+}  //  namespace NumberFormat
+
+/*
+ * Write count values separated by delimiter, stops before the first value
+ * that might not fit. Returns the characters written.
+ * */
+template <typename T>
+inline std::size_t FormatDecimalArray(const T* const values,
+                                      const std::size_t count,
+                                      const char delimiter, char* const out,
+                                      const std::size_t out_length) {
+  return NumberFormat::FormatArray(
+      values, count, delimiter, out, out_length, kMaxDecimalChars<T>,
+      [](const T value, char* const text) {
+        return FormatDecimal(value, text);
+      });
+}
+
+template <typename T>
+inline std::size_t FormatMicroArray(const T* const values,
+                                    const std::size_t count,
+                                    const char delimiter, char* const out,
+                                    const std::size_t out_length) {
+  return NumberFormat::FormatArray(
+      values, count, delimiter, out, out_length, kMaxMicroChars,
+      [](const T value, char* const text) { return FormatMicro(value, text); });
+}
+}  //  namespace Utilities
+
+#endif  //  UTILITIES_NUMBERFORMAT_H_
@@ -0,0 +1,174 @@
+/*
+ * Copyright 2020 ElectroOptical Innovations, LLC
+ *
+ * Serialization sink spanning a list of buffers, the writev iovec idea. A
+ * frame can be written straight into a header buffer, the free regions of a
+ * ring buffer and a trailer without assembling it first.
+ *
+ * std::array<Utilities::Segment, 3> segments{};
+ * segments[0] = {header.data(), header.size()};
+ * const std::size_t ring_segments =
+ *     Utilities::GetFreeSegments(&ring, &segments[1]);
+ * Utilities::SegmentWriter writer{segments.data(), 1 + ring_segments};
+ * writer.WriteInteger<Utilities::ByteOrder::kMsbFirst>(uint16_t{0x1234});
+ * ...
+ * ring.CommitInsert(writer.GetBytesWritten() - header.size());
+ * */
+#pragma once
+#ifndef UTILITIES_SEGMENTWRITER_H_
+#define UTILITIES_SEGMENTWRITER_H_
+
+#include <Utilities/Serializer.h>
+#include <Utilities/TypeConversion.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+namespace Utilities {
+struct Segment {
+  uint8_t* data;
+  std::size_t size;
+};
+
+/*
+ * Fill segments with the free regions of a ring buffer of bytes, returns
+ * the number of non empty segments written (0-2)
+ * */
+template <typename Ring>
+inline std::size_t GetFreeSegments(Ring* const ring, Segment* const segments) {
+  std::size_t count = 0;
+  std::size_t length = 0;
+  uint8_t* const first = ring->GetInsertRegion(&length);
+  if (length) {
+    segments[count++] = Segment{first, length};
+  }
+  uint8_t* const second = ring->GetWrappedInsertRegion(&length);
+  if (length) {
+    segments[count++] = Segment{second, length};
+  }
+  return count;
+}
+
+/*
+ * Every write is all or nothing, a value that does not fit in the remaining
+ * space writes nothing and returns 0
+ * */
+class SegmentWriter {
+  const Segment* const segments_;
+  const std::size_t segment_count_;
+  std::size_t segment_ = 0;
+  uint8_t* cursor_ = nullptr;
+  std::size_t cursor_space_ = 0;
+  std::size_t bytes_written_ = 0;
+  std::size_t remaining_ = 0;
+
+  void Advance(const std::size_t count) {
+    cursor_ += count;
+    cursor_space_ -= count;
+    bytes_written_ += count;
+    remaining_ -= count;
+    while (cursor_space_ == 0 && segment_ + 1 < segment_count_) {
+      segment_++;
+      cursor_ = segments_[segment_].data;
+      cursor_space_ = segments_[segment_].size;
+    }
+  }
+
+  /*
+   * store writes exactly kSize bytes to a contiguous pointer. Values inside
+   * the current segment are stored in place, values crossing a boundary are
+   * staged and scattered.
+   * */
+  template <std::size_t kSize, typename Store>
+  std::size_t WriteFixed(const Store& store) {
+    if (cursor_space_ >= kSize) {
+      store(cursor_);
+      Advance(kSize);
+      return kSize;
+    }
+    if (remaining_ < kSize) {
+      return 0;
+    }
+    std::array<uint8_t, kSize> staging{};
+    store(staging.data());
+    return write(staging.data(), kSize);
+  }
+
+ public:
+  /*
+   * Returns the bytes written, 0 if they do not all fit
+   * */
+  std::size_t write(const uint8_t* const data, const std::size_t length) {
+    if (remaining_ < length) {
+      return 0;
+    }
+    std::size_t offset = 0;
+    while (offset < length) {
+      const std::size_t step = std::min(cursor_space_, length - offset);
+      std::memcpy(cursor_, &data[offset], step);
+      offset += step;
+      Advance(step);
+    }
+    return length;
+  }
+
+  template <ByteOrder kOrder, typename T>
+  std::size_t WriteInteger(const T value) {
+    return WriteFixed<sizeof(T)>([value](uint8_t* const storage) {
+      StoreInteger<kOrder, T>(value, storage);
+    });
+  }
+
+  /*
+   * Native representation as written by Serializer<T>
+   * */
+  template <typename T>
+  std::size_t WriteValue(const T& value) {
+    return WriteFixed<Serializer<T>::kStep>([&value](uint8_t* const storage) {
+      Serializer<T>::serialize(storage, Serializer<T>::kStep, value);
+    });
+  }
+
+  template <typename T>
+  std::size_t WriteVarint(const T value) {
+    const std::size_t size = varint_size(value);
+    if (cursor_space_ >= size) {
+      write_varint(cursor_, cursor_space_, value);
+      Advance(size);
+      return size;
+    }
+    std::array<uint8_t, Varint::kMaxSize<T>> staging{};
+    write_varint(staging.data(), staging.size(), value);
+    return write(staging.data(), size);
+  }
+
+  /*
+   * Message described by a StructSerializer schema
+   * */
+  template <typename Schema, typename T>
+  std::size_t WriteStruct(const T& data) {
+    return WriteFixed<Schema::kSize>([&data](uint8_t* const storage) {
+      Schema::serialize(storage, Schema::kSize, data);
+    });
+  }
+
+  std::size_t GetBytesWritten(void) const { return bytes_written_; }
+  std::size_t GetRemaining(void) const { return remaining_; }
+
+  SegmentWriter(const Segment* const segments, const std::size_t segment_count)
+      : segments_{segments}, segment_count_{segment_count} {
+    for (std::size_t i = 0; i < segment_count_; i++) {
+      remaining_ += segments_[i].size;
+    }
+    if (segment_count_) {
+      cursor_ = segments_[0].data;
+      cursor_space_ = segments_[0].size;
+      Advance(0);
+    }
+  }
+};
+}  //  namespace Utilities
+
+#endif  //  UTILITIES_SEGMENTWRITER_H_
@@ -1,8 +1,12 @@
 #pragma once
+#include <Utilities/TypeConversion.h>
+
+#include <algorithm>
 #include <cassert>
 #include <climits>
 #include <cstddef>
 #include <cstdint>
+#include <limits>
 #include <type_traits>
 
 template <typename T,
@@ -79,3 +83,214 @@ void read_as_type(const uint8_t* storage, const size_t storage_length, T* data,
     }
   }
 }
+
+/*
+ * LEB128 variable length integers, 7 bits per byte LSB group first with the
+ * high bit set on every byte but the last. Signed values are zigzag encoded
+ * first so small magnitudes of either sign stay short.
+ * */
+namespace Varint {
+template <typename T>
+using WireType = std::make_unsigned_t<T>;
+
+template <typename T>
+static const constexpr size_t kMaxSize = (sizeof(T) * CHAR_BIT + 6) / 7;
+
+template <typename T>
+inline constexpr WireType<T> ToWire(const T value) {
+  static_assert(std::is_integral<T>::value);
+  if constexpr (std::is_signed<T>::value) {
+    return Utilities::ZigZagEncode<T>(value);
+  } else {
+    return value;
+  }
+}
+
+template <typename T>
+inline constexpr T FromWire(const WireType<T> value) {
+  if constexpr (std::is_signed<T>::value) {
+    return Utilities::ZigZagDecode<WireType<T>>(value);
+  } else {
+    return value;
+  }
+}
+
+static const constexpr uint64_t kContinuationBits = 0x8080808080808080;
+
+/*
+ * Collapse the 7 bit groups of length (1-8) little endian bytes into one
+ * value, the masked-VByte gather done with shifts instead of pext
+ * */
+inline constexpr uint64_t CompactGroups(uint64_t word, const size_t length) {
+  if (length < sizeof(uint64_t)) {
+    word &= (uint64_t{1} << (CHAR_BIT * length)) - 1;
+  }
+  word &= ~kContinuationBits;
+  word = ((word & 0x7f007f007f007f00) >> 1) | (word & 0x007f007f007f007f);
+  word = ((word & 0x3fff00003fff0000) >> 2) | (word & 0x00003fff00003fff);
+  word = ((word & 0x0fffffff00000000) >> 4) | (word & 0x000000000fffffff);
+  return word;
+}
+
+/*
+ * Bytes before the first terminator, terminators has only the high bit of
+ * each terminating byte set and is not 0
+ * */
+inline constexpr size_t CountBytesBeforeTerminator(const uint64_t terminators) {
+#if defined(__GNUC__)
+  return static_cast<size_t>(__builtin_ctzll(terminators)) / CHAR_BIT;
+#else
+  size_t count = 0;
+  while ((terminators & (uint64_t{0x80} << (CHAR_BIT * count))) == 0) {
+    count++;
+  }
+  return count;
+#endif
+}
+
+/*
+ * Byte at a time decode, used near the end of the buffer and for values
+ * longer than 8 bytes. Returns the bytes consumed, 0 if truncated or longer
+ * than T allows.
+ * */
+template <typename T>
+inline constexpr size_t ReadSlow(const uint8_t* storage,
+                                 const size_t storage_length, T* data) {
+  using Wire = WireType<T>;
+  const size_t length = std::min(storage_length, kMaxSize<T>);
+  uint64_t value = 0;
+  for (size_t i = 0; i < length; i++) {
+    const uint64_t group = storage[i] & 0x7f;
+    const size_t shift = 7 * i;
+    if (shift + 7 > 64 && (group >> (64 - shift))) {
+      return 0;
+    }
+    value |= group << shift;
+    if ((storage[i] & 0x80) == 0) {
+      if (value > std::numeric_limits<Wire>::max()) {
+        return 0;
+      }
+      *data = FromWire<T>(static_cast<Wire>(value));
+      return i + 1;
+    }
+  }
+  return 0;
+}
+}  //  namespace Varint
+
+template <typename T>
+inline constexpr size_t varint_size(const T value) {
+  auto wire = Varint::ToWire(value);
+  size_t size = 1;
+  for (; wire >= 0x80; wire = static_cast<decltype(wire)>(wire >> 7)) {
+    size++;
+  }
+  return size;
+}
+
+/*
+ * Returns the bytes written, 0 if the storage is too short
+ * */
+template <typename T>
+inline constexpr size_t write_varint(uint8_t* storage,
+                                     const size_t storage_length,
+                                     const T value) {
+  auto wire = Varint::ToWire(value);
+  if (wire < 0x80 && storage_length) {
+    storage[0] = static_cast<uint8_t>(wire);
+    return 1;
+  }
+  if (storage_length < varint_size(value)) {
+    return 0;
+  }
+  size_t bytes_written = 0;
+  for (; wire >= 0x80; wire = static_cast<decltype(wire)>(wire >> 7)) {
+    storage[bytes_written++] = static_cast<uint8_t>(0x80 | (wire & 0x7f));
+  }
+  storage[bytes_written++] = static_cast<uint8_t>(wire);
+  return bytes_written;
+}
+
+/*
+ * Returns the bytes consumed, 0 if the value is truncated or malformed
+ * */
+template <typename T>
+inline size_t read_varint(const uint8_t* storage, const size_t storage_length,
+                          T* data) {
+  if (storage_length >= sizeof(uint64_t)) {
+    const auto word =
+        Utilities::LoadInteger<Utilities::ByteOrder::kLsbFirst, uint64_t>(
+            storage);
+    const uint64_t terminators = ~word & Varint::kContinuationBits;
+    if (terminators) {
+      const size_t length = Varint::CountBytesBeforeTerminator(terminators) + 1;
+      if (length <= Varint::kMaxSize<T>) {
+        const uint64_t value = Varint::CompactGroups(word, length);
+        using Wire = Varint::WireType<T>;
+        if (value <= std::numeric_limits<Wire>::max()) {
+          *data = Varint::FromWire<T>(static_cast<Wire>(value));
+          return length;
+        }
+      }
+      return 0;
+    }
+  }
+  return Varint::ReadSlow(storage, storage_length, data);
+}
+
+/*
+ * Encode data_length values back to back, returns the bytes written or 0 if
+ * the storage is too short
+ * */
+template <typename T>
+inline size_t write_varint_array(uint8_t* storage, const size_t storage_length,
+                                 const T* data, const size_t data_length) {
+  size_t offset = 0;
+  for (size_t i = 0; i < data_length; i++) {
+    const size_t written =
+        write_varint(&storage[offset], storage_length - offset, data[i]);
+    if (written == 0) {
+      return 0;
+    }
+    offset += written;
+  }
+  return offset;
+}
+
+/*
+ * Decode data_length values, returns the bytes consumed or 0 if the storage
+ * runs out or holds a malformed value. Runs of eight single byte values are
+ * copied out of one 64 bit load.
+ * */
+template <typename T>
+inline size_t read_varint_array(const uint8_t* storage,
+                                const size_t storage_length, T* data,
+                                const size_t data_length) {
+  size_t offset = 0;
+  size_t i = 0;
+  while (i < data_length) {
+    if (storage_length - offset >= sizeof(uint64_t) &&
+        data_length - i >= sizeof(uint64_t)) {
+      const auto word =
+          Utilities::LoadInteger<Utilities::ByteOrder::kLsbFirst, uint64_t>(
+              &storage[offset]);
+      if ((word & Varint::kContinuationBits) == 0) {
+        for (size_t byte = 0; byte < sizeof(uint64_t); byte++) {
+          data[i + byte] = Varint::FromWire<T>(
+              static_cast<Varint::WireType<T>>(storage[offset + byte]));
+        }
+        offset += sizeof(uint64_t);
+        i += sizeof(uint64_t);
+        continue;
+      }
+    }
+    const size_t consumed =
+        read_varint(&storage[offset], storage_length - offset, &data[i]);
+    if (consumed == 0) {
+      return 0;
+    }
+    offset += consumed;
+    i++;
+  }
+  return offset;
+}
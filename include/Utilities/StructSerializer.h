@@ -0,0 +1,252 @@
+/*
+ * Copyright 2020 ElectroOptical Innovations, LLC
+ *
+ * Compile time message schema. A schema lists the members of a struct in
+ * wire order with the byte order of each, the wire size is known at compile
+ * time and packing is one bounds check followed by straight line stores.
+ *
+ * struct Message {
+ *   uint16_t address;
+ *   int32_t value;
+ *   std::array<uint8_t, 4> flags;
+ * };
+ * using MessageSerializer = Utilities::StructSerializer<
+ *     Message, Utilities::SchemaField<&Message::address>,
+ *     Utilities::SchemaField<&Message::value, Utilities::ByteOrder::kMsbFirst>,
+ *     Utilities::SchemaField<&Message::flags>>;
+ * static_assert(MessageSerializer::kSize == 10);
+ * */
+#pragma once
+#ifndef UTILITIES_STRUCTSERIALIZER_H_
+#define UTILITIES_STRUCTSERIALIZER_H_
+
+#include <Utilities/TypeConversion.h>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace Utilities {
+namespace Schema {
+/*
+ * Wire encoding of a single scalar, enums use their underlying type and
+ * floating point values are sent as their bit pattern
+ * */
+template <typename T, typename Enable = void>
+struct ScalarCodec {
+  static_assert(std::is_integral<T>(), "Unsupported schema field type");
+  static constexpr std::size_t kSize = sizeof(T);
+  template <ByteOrder kOrder>
+  static constexpr void Store(const T value, uint8_t* const data) {
+    StoreInteger<kOrder, T>(value, data);
+  }
+  template <ByteOrder kOrder>
+  static constexpr T Load(const uint8_t* const data) {
+    return LoadInteger<kOrder, T>(data);
+  }
+};
+
+template <>
+struct ScalarCodec<bool> {
+  static constexpr std::size_t kSize = 1;
+  template <ByteOrder>
+  static constexpr void Store(const bool value, uint8_t* const data) {
+    data[0] = value ? 1 : 0;
+  }
+  template <ByteOrder>
+  static constexpr bool Load(const uint8_t* const data) {
+    return data[0] != 0;
+  }
+};
+
+template <typename T>
+struct ScalarCodec<T, std::enable_if_t<std::is_enum<T>::value>> {
+  using Underlying = std::underlying_type_t<T>;
+  static constexpr std::size_t kSize = sizeof(Underlying);
+  template <ByteOrder kOrder>
+  static constexpr void Store(const T value, uint8_t* const data) {
+    StoreInteger<kOrder, Underlying>(static_cast<Underlying>(value), data);
+  }
+  template <ByteOrder kOrder>
+  static constexpr T Load(const uint8_t* const data) {
+    return static_cast<T>(LoadInteger<kOrder, Underlying>(data));
+  }
+};
+
+template <typename T>
+struct ScalarCodec<T, std::enable_if_t<std::is_floating_point<T>::value>> {
+  static_assert(sizeof(T) == sizeof(uint32_t) || sizeof(T) == sizeof(uint64_t));
+  using Bits = std::conditional_t<sizeof(T) == sizeof(uint32_t), uint32_t,
+                                  uint64_t>;
+  static constexpr std::size_t kSize = sizeof(T);
+  template <ByteOrder kOrder>
+  static void Store(const T value, uint8_t* const data) {
+    Bits bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    StoreInteger<kOrder, Bits>(bits, data);
+  }
+  template <ByteOrder kOrder>
+  static T Load(const uint8_t* const data) {
+    const Bits bits = LoadInteger<kOrder, Bits>(data);
+    T value{};
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+};
+
+template <typename T>
+struct FieldCodec {
+  static constexpr std::size_t kSize = ScalarCodec<T>::kSize;
+  template <ByteOrder kOrder>
+  static constexpr void Store(const T& value, uint8_t* const data) {
+    ScalarCodec<T>::template Store<kOrder>(value, data);
+  }
+  template <ByteOrder kOrder>
+  static constexpr void LoadInto(const uint8_t* const data, T* value) {
+    *value = ScalarCodec<T>::template Load<kOrder>(data);
+  }
+};
+
+/*
+ * Fixed length arrays are sent element by element in the field byte order
+ * */
+template <typename T, std::size_t kLength>
+struct FieldCodec<std::array<T, kLength>> {
+  static constexpr std::size_t kSize = ScalarCodec<T>::kSize * kLength;
+  template <ByteOrder kOrder>
+  static constexpr void Store(const std::array<T, kLength>& value,
+                              uint8_t* const data) {
+    for (std::size_t i = 0; i < kLength; i++) {
+      ScalarCodec<T>::template Store<kOrder>(
+          value[i], &data[i * ScalarCodec<T>::kSize]);
+    }
+  }
+  template <ByteOrder kOrder>
+  static constexpr void LoadInto(const uint8_t* const data,
+                                 std::array<T, kLength>* value) {
+    for (std::size_t i = 0; i < kLength; i++) {
+      (*value)[i] = ScalarCodec<T>::template Load<kOrder>(
+          &data[i * ScalarCodec<T>::kSize]);
+    }
+  }
+};
+
+template <typename T>
+struct MemberPointerTraits;
+
+template <typename Class, typename Member>
+struct MemberPointerTraits<Member Class::*> {
+  using ClassType = Class;
+  using MemberType = Member;
+};
+}  //  namespace Schema
+
+/*
+ * One member of a message in wire order
+ * */
+template <auto kMember, ByteOrder kOrder = ByteOrder::kLsbFirst>
+struct SchemaField {
+  using Traits = Schema::MemberPointerTraits<decltype(kMember)>;
+  using ClassType = typename Traits::ClassType;
+  using MemberType = typename Traits::MemberType;
+  using Codec = Schema::FieldCodec<MemberType>;
+  static constexpr std::size_t kSize = Codec::kSize;
+
+  static constexpr void Store(const ClassType& data, uint8_t* const storage) {
+    Codec::template Store<kOrder>(data.*kMember, storage);
+  }
+  static constexpr void Load(const uint8_t* const storage, ClassType* data) {
+    Codec::template LoadInto<kOrder>(storage, &(data->*kMember));
+  }
+};
+
+/*
+ * Packs and unpacks a struct as the concatenation of its schema fields
+ * */
+template <typename T, typename... Fields>
+class StructSerializer {
+  static_assert(sizeof...(Fields) > 0, "Schema has no fields");
+  static_assert((std::is_same<T, typename Fields::ClassType>::value && ...),
+                "Schema field is not a member of the message");
+
+  using FieldTuple = std::tuple<Fields...>;
+  template <std::size_t kIndex>
+  using FieldAt = std::tuple_element_t<kIndex, FieldTuple>;
+
+  static constexpr std::array<std::size_t, sizeof...(Fields)> kOffsets =
+      [] {
+        std::array<std::size_t, sizeof...(Fields)> offsets{};
+        const std::array<std::size_t, sizeof...(Fields)> sizes{
+            Fields::kSize...};
+        std::size_t offset = 0;
+        for (std::size_t i = 0; i < sizes.size(); i++) {
+          offsets[i] = offset;
+          offset += sizes[i];
+        }
+        return offsets;
+      }();
+
+  template <std::size_t... kIndex>
+  static constexpr void StoreFields(const T& data, uint8_t* const storage,
+                                    std::index_sequence<kIndex...>) {
+    (FieldAt<kIndex>::Store(data, &storage[kOffsets[kIndex]]), ...);
+  }
+
+  template <std::size_t... kIndex>
+  static constexpr void LoadFields(const uint8_t* const storage, T* data,
+                                   std::index_sequence<kIndex...>) {
+    (FieldAt<kIndex>::Load(&storage[kOffsets[kIndex]], data), ...);
+  }
+
+ public:
+  static constexpr std::size_t kSize = (Fields::kSize + ...);
+  static constexpr std::size_t kFieldCount = sizeof...(Fields);
+
+  static constexpr std::size_t GetFieldOffset(const std::size_t field) {
+    return kOffsets[field];
+  }
+
+  /*
+   * Returns the bytes written, 0 if the storage is too short
+   * */
+  static constexpr std::size_t serialize(uint8_t* const storage,
+                                         const std::size_t storage_length,
+                                         const T& data) {
+    if (storage_length < kSize) {
+      return 0;
+    }
+    StoreFields(data, storage, std::index_sequence_for<Fields...>{});
+    return kSize;
+  }
+
+  /*
+   * Returns the bytes read, 0 if the storage is too short
+   * */
+  static constexpr std::size_t deserialize(const uint8_t* const storage,
+                                           const std::size_t storage_length,
+                                           T* const data) {
+    if (storage_length < kSize) {
+      return 0;
+    }
+    LoadFields(storage, data, std::index_sequence_for<Fields...>{});
+    return kSize;
+  }
+
+  static constexpr std::array<uint8_t, kSize> ToArray(const T& data) {
+    std::array<uint8_t, kSize> out{};
+    StoreFields(data, out.data(), std::index_sequence_for<Fields...>{});
+    return out;
+  }
+
+  static constexpr T FromArray(const std::array<uint8_t, kSize>& storage) {
+    T data{};
+    LoadFields(storage.data(), &data, std::index_sequence_for<Fields...>{});
+    return data;
+  }
+};
+}  //  namespace Utilities
+
+#endif  //  UTILITIES_STRUCTSERIALIZER_H_
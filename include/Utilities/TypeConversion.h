@@ -8,11 +8,15 @@
 #define UTILITIES_TYPECONVERSION_H_
 
 //#include <ArrayView/ArrayView.h>
+#include <Utilities/NumberFormat.h>
+
 #include <algorithm>
 #include <array>
 #include <cassert>
 #include <cstdint>
+#include <cstring>
 #include <limits>
+#include <type_traits>
 
 namespace Utilities {
 template <typename T = int>
@@ -22,6 +26,32 @@ constexpr T SignExtend(const T data, const std::size_t bits) {
   return converted;
 }
 
+/*
+ * Map signed values to unsigned so small magnitudes of either sign have few
+ * significant bits: 0, -1, 1, -2 -> 0, 1, 2, 3
+ * */
+template <typename T>
+inline constexpr std::make_unsigned_t<T> ZigZagEncode(const T value) {
+  static_assert(std::is_signed<T>() && std::is_integral<T>());
+  using Unsigned = std::make_unsigned_t<T>;
+  const auto sign = static_cast<Unsigned>(value < 0 ? ~Unsigned{0} : 0);
+  return static_cast<Unsigned>((static_cast<Unsigned>(value) << 1) ^ sign);
+}
+
+template <typename T>
+inline constexpr std::make_signed_t<T> ZigZagDecode(const T value) {
+  static_assert(std::is_unsigned<T>());
+  const auto sign = static_cast<T>(0 - (value & 1));
+  return static_cast<std::make_signed_t<T>>(static_cast<T>(value >> 1) ^ sign);
+}
+
+static_assert(ZigZagEncode<int32_t>(0) == 0);
+static_assert(ZigZagEncode<int32_t>(-1) == 1);
+static_assert(ZigZagEncode<int32_t>(1) == 2);
+static_assert(ZigZagEncode<int16_t>(-32768) == 65535);
+static_assert(ZigZagDecode<uint32_t>(3) == -2);
+static_assert(ZigZagDecode<uint16_t>(65535) == -32768);
+
 inline constexpr std::size_t CalcNumberOfBytesToFitBits(
     const std::size_t coil_count) {
   const std::size_t kByteSize = 8;
@@ -31,6 +61,142 @@ inline constexpr std::size_t CalcNumberOfBytesToFitBits(
   return num_bytes_truncated + num_bytes_partial;
 }
 
+/*
+ * Byte order of a value on the wire, LSB first is little endian
+ * */
+enum class ByteOrder { kLsbFirst, kMsbFirst };
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+const constexpr ByteOrder kHostByteOrder = ByteOrder::kMsbFirst;
+#else
+const constexpr ByteOrder kHostByteOrder = ByteOrder::kLsbFirst;
+#endif
+
+/*
+ * Write an integral value to sizeof(T) bytes in the given order. The
+ * shifts collapse to a single (byte swapped) store on gcc and clang.
+ * */
+template <ByteOrder kOrder, typename T>
+inline constexpr void StoreInteger(const T value, uint8_t *const data) {
+  static_assert(std::is_integral<T>());
+  using Unsigned = std::make_unsigned_t<T>;
+  const auto cast = static_cast<Unsigned>(value);
+  for (std::size_t byte = 0; byte < sizeof(T); byte++) {
+    const std::size_t position =
+        kOrder == ByteOrder::kLsbFirst ? byte : sizeof(T) - 1 - byte;
+    data[position] = static_cast<uint8_t>(0xff & (cast >> (byte * 8)));
+  }
+}
+
+template <ByteOrder kOrder, typename T>
+inline constexpr T LoadInteger(const uint8_t *const data) {
+  static_assert(std::is_integral<T>());
+  using Unsigned = std::make_unsigned_t<T>;
+  Unsigned out = 0;
+  for (std::size_t byte = 0; byte < sizeof(T); byte++) {
+    const std::size_t position =
+        kOrder == ByteOrder::kLsbFirst ? byte : sizeof(T) - 1 - byte;
+    out = static_cast<Unsigned>(out |
+                                (static_cast<Unsigned>(data[position])
+                                 << (byte * 8)));
+  }
+  return static_cast<T>(out);
+}
+
+inline constexpr uint16_t ByteSwap(const uint16_t value) {
+#if defined(__GNUC__)
+  return __builtin_bswap16(value);
+#else
+  return static_cast<uint16_t>((value << 8) | (value >> 8));
+#endif
+}
+
+inline constexpr uint32_t ByteSwap(const uint32_t value) {
+#if defined(__GNUC__)
+  return __builtin_bswap32(value);
+#else
+  return (value << 24) | ((value << 8) & 0xff0000) | ((value >> 8) & 0xff00) |
+         (value >> 24);
+#endif
+}
+
+inline constexpr uint64_t ByteSwap(const uint64_t value) {
+#if defined(__GNUC__)
+  return __builtin_bswap64(value);
+#else
+  return (static_cast<uint64_t>(ByteSwap(static_cast<uint32_t>(value))) << 32) |
+         ByteSwap(static_cast<uint32_t>(value >> 32));
+#endif
+}
+
+/*
+ * Unsigned integer with the same size as T, used to move floats and signed
+ * types through the byte swapping paths by bit pattern
+ * */
+template <std::size_t kBytes>
+struct UnsignedOfSize;
+template <>
+struct UnsignedOfSize<1> {
+  using type = uint8_t;
+};
+template <>
+struct UnsignedOfSize<2> {
+  using type = uint16_t;
+};
+template <>
+struct UnsignedOfSize<4> {
+  using type = uint32_t;
+};
+template <>
+struct UnsignedOfSize<8> {
+  using type = uint64_t;
+};
+
+/*
+ * Write count elements of data_in to the wire in the given byte order.
+ * When the wire order matches the host this is a single memcpy, otherwise
+ * each element is byte swapped. Floating point types are sent as their bit
+ * pattern.
+ * */
+template <ByteOrder kOrder, typename T>
+inline void StoreArray(const T *const data_in, uint8_t *const data_out,
+                       const std::size_t count) {
+  static_assert(std::is_arithmetic<T>(), "Only arithmetic types supported");
+  using Bits = typename UnsignedOfSize<sizeof(T)>::type;
+  if constexpr (kOrder == kHostByteOrder || sizeof(T) == 1) {
+    //  empty arrays may come with null pointers which memcpy does not allow
+    if (count) {
+      std::memcpy(data_out, data_in, count * sizeof(T));
+    }
+  } else {
+    for (std::size_t i = 0; i < count; i++) {
+      Bits bits = 0;
+      std::memcpy(&bits, &data_in[i], sizeof(T));
+      bits = ByteSwap(bits);
+      std::memcpy(&data_out[i * sizeof(T)], &bits, sizeof(T));
+    }
+  }
+}
+
+template <ByteOrder kOrder, typename T>
+inline void LoadArray(const uint8_t *const data_in, T *const data_out,
+                      const std::size_t count) {
+  static_assert(std::is_arithmetic<T>(), "Only arithmetic types supported");
+  using Bits = typename UnsignedOfSize<sizeof(T)>::type;
+  if constexpr (kOrder == kHostByteOrder || sizeof(T) == 1) {
+    if (count) {
+      std::memcpy(data_out, data_in, count * sizeof(T));
+    }
+  } else {
+    for (std::size_t i = 0; i < count; i++) {
+      Bits bits = 0;
+      std::memcpy(&bits, &data_in[i * sizeof(T)], sizeof(T));
+      bits = ByteSwap(bits);
+      std::memcpy(&data_out[i], &bits, sizeof(T));
+    }
+  }
+}
+
 template <std::size_t byte_swap_count, typename T>
 void SwitchByteOrder(T &data) {
   assert(data.size() % byte_swap_count == 0);
@@ -127,7 +293,7 @@ inline constexpr T Make_MSB_IntegerTypeFromU8Array(
 
 template <>
 inline constexpr uint8_t Make_MSB_IntegerTypeFromU8Array<uint8_t>(
-    const uint8_t *const data, const std::size_t data_length) {
+    const uint8_t *const data, const std::size_t /*data_length*/) {
   return data[0];
 }
 
@@ -215,11 +381,12 @@ inline constexpr std::array<uint8_t, sizeof(T)> MakeMSBU8Array(T t) {
   return MakeMSBU8Array<T, sizeof(T)>(t);
 }
 
+/*
+ * Convert length bytes of MSB first data to length/sizeof(T) entries
+ * */
 template <typename T>
 inline void ConvertToType(const uint8_t *data, T *entry, const size_t length) {
-  for (size_t i = 0; i < length; i += sizeof(T)) {
-    entry[i] = Make_MSB_IntegerTypeFromArray<T, uint8_t>(&data[i], length);
-  }
+  LoadArray<ByteOrder::kMsbFirst, T>(data, entry, length / sizeof(T));
 }
 
 template <>
@@ -258,15 +425,14 @@ MakeU8Array(T t) {
   return MakeLSBU8Array<T>(t);
 }
 
+/*
+ * Write the low 9 digits of num zero padded, see NumberFormat.h for the
+ * variable width formatters
+ * */
 inline void num2chars(
     uint32_t num,
     std::array<char, std::numeric_limits<uint32_t>::digits10> &buff) {
-  const int base = 10;
-  for (auto entry = buff.rbegin(); entry < buff.rend(); ++entry) {
-    const auto rem = static_cast<char>((num - (num / base) * base) & (0xff));
-    num = num / base;
-    *entry = static_cast<char>(('0' + rem) & 0xff);
-  }
+  FormatFixedWidth(num, buff.data(), buff.size());
 }
 
 template <typename T, typename U>
@@ -279,26 +445,15 @@ inline constexpr T StaticCastQuickFail(U x) {
   return static_cast<T>(x);
 }
 
-template <typename T>
+/*
+ * Write as many of the size_in elements as fit in size_out bytes, MSB first
+ * by default
+ * */
+template <typename T, ByteOrder kOrder = ByteOrder::kMsbFirst>
 void ArrayToBytes(const T *const data_in, uint8_t *const data_out,
                   const std::size_t size_in, const std::size_t size_out) {
-  std::size_t data_out_count = 0;
-  for (std::size_t i = 0; i < std::min(size_in, size_out / sizeof(T)); i++) {
-    const auto arr = MakeMSBU8Array<T>(data_in[i]);
-    for (std::size_t j = 0; j < arr.size(); j++) {
-      data_out[i * sizeof(T) + j] = arr[j];
-    }
-  }
-}
-
-template <>
-inline void ArrayToBytes<uint8_t>(const uint8_t *const data_in,
-                                  uint8_t *const data_out,
-                                  const std::size_t size_in,
-                                  const std::size_t size_out) {
-  for (std::size_t i = 0; i < std::min(size_in, size_out); i++) {
-    data_out[i] = data_in[i];
-  }
+  StoreArray<kOrder, T>(data_in, data_out,
+                        std::min(size_in, size_out / sizeof(T)));
 }
 
 template <typename T>
@@ -312,22 +467,15 @@ inline size_t ConvertToBytes(const T &data, uint8_t *entry,
   return chars;
 }
 
-template <typename T>
+/*
+ * Read as many elements as are complete in size_in bytes and fit in
+ * size_out elements, MSB first by default
+ * */
+template <typename T, ByteOrder kOrder = ByteOrder::kMsbFirst>
 void ArrayFromBytes(const uint8_t *const data_in, T *const data_out,
                     const std::size_t size_in, const std::size_t size_out) {
-  for (std::size_t i = 0; i < std::min(size_in / sizeof(T), size_out); i++) {
-    data_out[i] = ConvertToType<T>(&data_in[i * sizeof(T)], sizeof(T));
-  }
-}
-
-template <>
-inline void ArrayFromBytes<uint8_t>(const uint8_t *const data_in,
-                                    uint8_t *const data_out,
-                                    const std::size_t size_in,
-                                    const std::size_t size_out) {
-  for (std::size_t i = 0; i < std::min(size_in, size_out); i++) {
-    data_out[i] = data_in[i];
-  }
+  LoadArray<kOrder, T>(data_in, data_out,
+                       std::min(size_in / sizeof(T), size_out));
 }
 
 #if 0
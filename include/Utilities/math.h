@@ -1,79 +1,446 @@
+/*
+ * Copyright 2020 ElectroOptical Innovations, LLC
+ *
+ * constexpr exp, log, pow, round, floor and ceil that give the same results
+ * at compile time on every compiler, so tables can be generated with
+ * constexpr without relying on libm builtins being folded.
+ *
+ * exp, log and pow come in two accuracy tiers:
+ *   MathAccuracy::kFast  relative error below 2e-7, float precision
+ *   MathAccuracy::kExact exp and log within a couple of ulp. pow is
+ *                        exp(y log(x)) so the log error is scaled by y log(x),
+ *                        around 1e-14 relative for results in the double range
+ *
+ * Both reduce the argument to a small interval with a power of two and
+ * evaluate a short polynomial with Horner's rule. At runtime the power of
+ * two is read from or written to the bit pattern and special values are
+ * selected with masks, during constant evaluation it is found by exact
+ * scaling. Either way the result is bit identical. There are no branches
+ * per element, GCC vectorizes the array versions at -O3 on targets with
+ * vector conversions between double and int64 (AVX-512), not at -O2.
+ * */
 #pragma once
+#ifndef UTILITIES_MATH_H_
+#define UTILITIES_MATH_H_
+
+#include <array>
+#include <cassert>
+#include <cstddef>
 #include <cstdint>
-#ifdef __clang__
-#include <Sprout/sprout/cmath.hpp>
-#include <Sprout/sprout/math/exp.hpp>
-#include <Sprout/sprout/math/log.hpp>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#if defined(__GNUC__)
+#define UTILITIES_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
 #else
-#include <cmath>
+//  always take the portable scaling path
+#define UTILITIES_IS_CONSTANT_EVALUATED() true
 #endif
 
 namespace Utilities {
-#ifdef __clang__
-using sprout::math::ceil;
-using sprout::math::exp;
-using sprout::math::floor;
-using sprout::math::log;
-using sprout::math::pow;
-//  using sprout::math::round;
-//  using sprout::math::abs;
-//  using exp = sprout::math::detail::exp;
-//  using log = sprout::math::detail::log;
+enum class MathAccuracy { kFast, kExact };
 
-#else
-using std::ceil;
-using std::exp;
-using std::floor;
-using std::log;
-using std::pow;
-//  using std::round;
-//  using std::abs;
-#endif
+namespace MathDetail {
+const constexpr double kLn2 = 0.69314718055994530942;
+//  ln(2) split so k * kLn2High is exact for |k| < 2^11
+const constexpr double kLn2High = 6.93147180369123816490e-01;
+const constexpr double kLn2Low = 1.90821492927058770002e-10;
+const constexpr double kLog2e = 1.44269504088896340736;
+const constexpr double kSqrt2 = 1.41421356237309504880;
+const constexpr double kSqrtHalf = 0.70710678118654752440;
+const constexpr double kTwo32 = 4294967296.0;
+const constexpr double kTwo54 = 18014398509481984.0;
+//  exp overflows above and is 0 below
+const constexpr double kExpMax = 709.782712893383973096;
+const constexpr double kExpMin = -745.133219101941108420;
+const constexpr double kInfinity = std::numeric_limits<double>::infinity();
+const constexpr double kNan = std::numeric_limits<double>::quiet_NaN();
 
-#if 0
-template <typename T, typename U = int64_t>
-inline constexpr T floor(const T value) {
-#ifdef __clang__
-  static_assert(std::is_integral<U>());
-  return (static_cast<T>(static_cast<U>(value)));
-#else
-  return std::floor(value);
-#endif
+inline double FromBits(const uint64_t bits) {
+  double value = 0;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
 }
 
-template <typename T, typename U = int64_t>
-inline constexpr T ceil(const T value) {
-#ifdef __clang__
-  static_assert(std::is_integral<U>());
-  return (static_cast<T>(static_cast<U>(value - 0.5)) + 1);
-#else
-  return std::ceil(value);
-#endif
+inline uint64_t ToBits(const double value) {
+  uint64_t bits = 0;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+/*
+ * condition ? a : b done with a bit mask at runtime. Both sides are always
+ * evaluated, so the compiler can not split the code after it into separate
+ * paths, which would stop a loop from vectorizing.
+ * */
+inline constexpr double Select(const bool condition, const double a,
+                               const double b) {
+  if (UTILITIES_IS_CONSTANT_EVALUATED()) {
+    return condition ? a : b;
+  }
+  const uint64_t mask = 0 - static_cast<uint64_t>(condition);
+  return FromBits((ToBits(a) & mask) | (ToBits(b) & ~mask));
+}
+
+/*
+ * 2^exponent for exponents of normal doubles, [-1022, 1023]
+ * */
+inline constexpr double Pow2Normal(const int64_t exponent) {
+  if (UTILITIES_IS_CONSTANT_EVALUATED()) {
+    assert(exponent >= -1022 && exponent <= 1023);
+    double result = 1;
+    double base = exponent < 0 ? 0.5 : 2.0;
+    for (int64_t n = exponent < 0 ? -exponent : exponent; n; n >>= 1) {
+      result = (n & 1) ? result * base : result;
+      //  the square after the last bit could overflow
+      base = n > 1 ? base * base : base;
+    }
+    return result;
+  }
+  return FromBits(static_cast<uint64_t>(exponent + 1023) << 52);
+}
+
+/*
+ * value = mantissa * 2^exponent with the mantissa in [sqrt(1/2), sqrt(2)),
+ * value must be positive and finite
+ * */
+struct Decomposed {
+  double mantissa = 0;
+  int64_t exponent = 0;
+};
+
+inline constexpr Decomposed Decompose(const double value) {
+  if (UTILITIES_IS_CONSTANT_EVALUATED()) {
+    assert(value > 0 && value < kInfinity);
+    Decomposed out{value, 0};
+    while (out.mantissa >= kTwo32) {
+      out.mantissa /= kTwo32;
+      out.exponent += 32;
+    }
+    while (out.mantissa < 1 / kTwo32) {
+      out.mantissa *= kTwo32;
+      out.exponent -= 32;
+    }
+    while (out.mantissa >= kSqrt2) {
+      out.mantissa *= 0.5;
+      out.exponent++;
+    }
+    while (out.mantissa < kSqrtHalf) {
+      out.mantissa *= 2;
+      out.exponent--;
+    }
+    return out;
+  }
+  //  subnormals are scaled into the normal range first
+  const bool subnormal = value < std::numeric_limits<double>::min();
+  uint64_t bits = ToBits(Select(subnormal, value * kTwo54, value));
+  const int64_t exponent = static_cast<int64_t>((bits >> 52) & 0x7ff) - 1023 -
+                           (subnormal ? 54 : 0);
+  //  same mantissa with the exponent of 1.0, [1, 2)
+  bits = (bits & 0x000fffffffffffff) | 0x3ff0000000000000;
+  const double mantissa = FromBits(bits);
+  const bool high = mantissa >= kSqrt2;
+  return Decomposed{Select(high, mantissa * 0.5, mantissa),
+                    exponent + (high ? 1 : 0)};
+}
+
+/*
+ * Horner's rule, highest power first
+ * */
+template <std::size_t kTerms>
+inline constexpr double Polynomial(const double x,
+                                   const double (&coefficients)[kTerms]) {
+  double result = 0;
+  for (std::size_t i = 0; i < kTerms; i++) {
+    result = result * x + coefficients[i];
+  }
+  return result;
+}
+
+inline constexpr double Trunc(const double value) {
+  //  at 2^52 and above every double is an integer, NaN falls through too
+  const bool integral = !(value > -4503599627370496.0 &&
+                          value < 4503599627370496.0);
+  return integral ? value
+                  : static_cast<double>(static_cast<int64_t>(value));
+}
+}  //  namespace MathDetail
+
+/*
+ * e^value
+ * */
+template <MathAccuracy kAccuracy = MathAccuracy::kExact>
+inline constexpr double Exp(const double value) {
+  //  every operation is done for every value and the special cases are
+  //  selected, so a loop has no branches. NaN goes to the low clamp.
+  const bool overflow = value > MathDetail::kExpMax;
+  const bool in_range = value >= MathDetail::kExpMin;
+  const bool nan = value != value;
+  const double x = MathDetail::Select(
+      overflow, MathDetail::kExpMax,
+      MathDetail::Select(in_range, value, MathDetail::kExpMin));
+  //  value = k ln(2) + r, |r| <= ln(2) / 2
+  const int64_t k =
+      static_cast<int64_t>(x * MathDetail::kLog2e + (x < 0 ? -0.5 : 0.5));
+  const double kd = static_cast<double>(k);
+  const double r = (x - kd * MathDetail::kLn2High) - kd * MathDetail::kLn2Low;
+  double polynomial = 0;
+  if constexpr (kAccuracy == MathAccuracy::kFast) {
+    //  1 / n! to the 6th power
+    const constexpr double kTaylor[] = {1.0 / 720, 1.0 / 120, 1.0 / 24,
+                                        1.0 / 6,   1.0 / 2,   1.0, 1.0};
+    polynomial = MathDetail::Polynomial(r, kTaylor);
+  } else {
+    //  1 / n! to the 13th power
+    const constexpr double kTaylor[] = {
+        1.0 / 6227020800, 1.0 / 479001600, 1.0 / 39916800, 1.0 / 3628800,
+        1.0 / 362880,     1.0 / 40320,     1.0 / 5040,     1.0 / 720,
+        1.0 / 120,        1.0 / 24,        1.0 / 6,        1.0 / 2,
+        1.0,              1.0};
+    polynomial = MathDetail::Polynomial(r, kTaylor);
+  }
+  //  powers of two outside the normal range are applied in two steps
+  const bool low = k < -1022;
+  const bool high = k > 1023;
+  const int64_t k_normal = low ? k + 54 : (high ? k - 1 : k);
+  const double scaled = polynomial * MathDetail::Pow2Normal(k_normal) *
+                        (low ? 1 / MathDetail::kTwo54 : (high ? 2.0 : 1.0));
+  const double result = MathDetail::Select(
+      overflow, MathDetail::kInfinity,
+      MathDetail::Select(in_range, scaled, 0.0));
+  return MathDetail::Select(nan, value, result);
+}
+
+/*
+ * Natural log, -inf at 0 and NaN below
+ * */
+template <MathAccuracy kAccuracy = MathAccuracy::kExact>
+inline constexpr double Log(const double value) {
+  //  special values are selected at the end so a loop has no branches
+  const bool positive = value > 0;
+  const bool finite_positive = positive & (value < MathDetail::kInfinity);
+  const MathDetail::Decomposed decomposed =
+      MathDetail::Decompose(MathDetail::Select(finite_positive, value, 1.0));
+  //  ln(m) = 2 atanh(s), |s| <= 0.1716
+  const double s = (decomposed.mantissa - 1) / (decomposed.mantissa + 1);
+  const double s2 = s * s;
+  double series = 0;
+  if constexpr (kAccuracy == MathAccuracy::kFast) {
+    const constexpr double kAtanh[] = {2.0 / 7, 2.0 / 5, 2.0 / 3, 2.0};
+    series = MathDetail::Polynomial(s2, kAtanh);
+  } else {
+    const constexpr double kAtanh[] = {2.0 / 19, 2.0 / 17, 2.0 / 15, 2.0 / 13,
+                                       2.0 / 11, 2.0 / 9,  2.0 / 7,  2.0 / 5,
+                                       2.0 / 3,  2.0};
+    series = MathDetail::Polynomial(s2, kAtanh);
+  }
+  const double k = static_cast<double>(decomposed.exponent);
+  const double result =
+      k * MathDetail::kLn2High + (k * MathDetail::kLn2Low + s * series);
+  const double special = MathDetail::Select(
+      positive, value,
+      MathDetail::Select(value == 0, -MathDetail::kInfinity, MathDetail::kNan));
+  return MathDetail::Select(finite_positive, result, special);
+}
+
+namespace MathDetail {
+inline constexpr bool IsSmallInteger(const double exponent) {
+  return Trunc(exponent) == exponent && exponent >= -64 && exponent <= 64;
+}
+
+/*
+ * Factor for a negative base, -1 for odd integer exponents, 1 for even and
+ * NaN otherwise
+ * */
+inline constexpr double NegativeBaseSign(const double exponent) {
+  const bool integral = Trunc(exponent) == exponent;
+  const bool odd = Trunc(exponent * 0.5) != exponent * 0.5;
+  return integral ? (odd ? -1.0 : 1.0) : kNan;
+}
+
+/*
+ * base^exponent as e^(exponent ln|base|), a negative base is multiplied by
+ * sign from NegativeBaseSign. 0 gives e^(-inf) or e^inf.
+ * */
+template <MathAccuracy kAccuracy>
+inline constexpr double PowByLog(const double base, const double exponent,
+                                 const double sign) {
+  const bool negative = base < 0;
+  const double magnitude =
+      Exp<kAccuracy>(exponent * Log<kAccuracy>(Select(negative, -base, base)));
+  return Select(negative, magnitude * sign, magnitude);
+}
+}  //  namespace MathDetail
+
+/*
+ * base^exponent. Integer exponents up to 64 are done by squaring so powers
+ * of 2 are exact, a negative base needs an integer exponent.
+ * */
+template <MathAccuracy kAccuracy = MathAccuracy::kExact>
+inline constexpr double Pow(const double base, const double exponent) {
+  if (MathDetail::IsSmallInteger(exponent)) {
+    double result = 1;
+    double square = exponent < 0 ? 1 / base : base;
+    for (int64_t n = static_cast<int64_t>(exponent < 0 ? -exponent : exponent);
+         n; n >>= 1) {
+      result = (n & 1) ? result * square : result;
+      square = n > 1 ? square * square : square;
+    }
+    return result;
+  }
+  return MathDetail::PowByLog<kAccuracy>(
+      base, exponent, MathDetail::NegativeBaseSign(exponent));
+}
+
+/*
+ * Nearest integer with halves away from zero like std::round
+ * */
+inline constexpr double Round(const double value) {
+  const double truncated = MathDetail::Trunc(value);
+  const double fraction = value - truncated;
+  return fraction >= 0.5
+             ? truncated + 1
+             : (fraction <= -0.5 ? truncated - 1 : truncated);
+}
+
+inline constexpr double Floor(const double value) {
+  const double truncated = MathDetail::Trunc(value);
+  return truncated > value ? truncated - 1 : truncated;
+}
+
+inline constexpr double Ceil(const double value) {
+  const double truncated = MathDetail::Trunc(value);
+  return truncated < value ? truncated + 1 : truncated;
+}
+
+/*
+ * Array versions, the fast tier is meant for these
+ * */
+template <MathAccuracy kAccuracy = MathAccuracy::kFast>
+inline void Exp(const double* const values, const std::size_t count,
+                double* const out) {
+  for (std::size_t i = 0; i < count; i++) {
+    out[i] = Exp<kAccuracy>(values[i]);
+  }
+}
+
+template <MathAccuracy kAccuracy = MathAccuracy::kFast>
+inline void Log(const double* const values, const std::size_t count,
+                double* const out) {
+  for (std::size_t i = 0; i < count; i++) {
+    out[i] = Log<kAccuracy>(values[i]);
+  }
+}
+
+/*
+ * The exponent is shared so the squaring is a pass over a block per bit of
+ * the exponent, out may be bases
+ * */
+template <MathAccuracy kAccuracy = MathAccuracy::kFast>
+inline void Pow(const double* const bases, const double exponent,
+                const std::size_t count, double* const out) {
+  if (!MathDetail::IsSmallInteger(exponent)) {
+    const double sign = MathDetail::NegativeBaseSign(exponent);
+    for (std::size_t i = 0; i < count; i++) {
+      out[i] = MathDetail::PowByLog<kAccuracy>(bases[i], exponent, sign);
+    }
+    return;
+  }
+  const constexpr std::size_t kBlockSize = 64;
+  const int64_t power =
+      static_cast<int64_t>(exponent < 0 ? -exponent : exponent);
+  std::array<double, kBlockSize> square{};
+  for (std::size_t offset = 0; offset < count; offset += kBlockSize) {
+    const std::size_t block =
+        count - offset < kBlockSize ? count - offset : kBlockSize;
+    double* const result = out + offset;
+    if (exponent < 0) {
+      for (std::size_t i = 0; i < block; i++) {
+        square[i] = 1 / bases[offset + i];
+      }
+    } else {
+      for (std::size_t i = 0; i < block; i++) {
+        square[i] = bases[offset + i];
+      }
+    }
+    for (std::size_t i = 0; i < block; i++) {
+      result[i] = 1;
+    }
+    for (int64_t n = power; n; n >>= 1) {
+      if (n & 1) {
+        for (std::size_t i = 0; i < block; i++) {
+          result[i] *= square[i];
+        }
+      }
+      if (n > 1) {
+        for (std::size_t i = 0; i < block; i++) {
+          square[i] *= square[i];
+        }
+      }
+    }
+  }
+}
+
+/*
+ * std style names used through the library, integer arguments compute in
+ * double like the std overloads
+ * */
+template <typename T>
+using MathResult = std::conditional_t<std::is_floating_point<T>::value, T,
+                                      double>;
+
+template <typename T>
+inline constexpr MathResult<T> exp(const T value) {
+  return static_cast<MathResult<T>>(Exp(static_cast<double>(value)));
+}
+
+template <typename T>
+inline constexpr MathResult<T> log(const T value) {
+  return static_cast<MathResult<T>>(Log(static_cast<double>(value)));
+}
+
+template <typename T, typename U>
+inline constexpr MathResult<std::common_type_t<T, U>> pow(const T base,
+                                                          const U exponent) {
+  return static_cast<MathResult<std::common_type_t<T, U>>>(
+      Pow(static_cast<double>(base), static_cast<double>(exponent)));
+}
+
+template <typename T>
+inline constexpr MathResult<T> floor(const T value) {
+  return static_cast<MathResult<T>>(Floor(static_cast<double>(value)));
+}
+
+template <typename T>
+inline constexpr MathResult<T> ceil(const T value) {
+  return static_cast<MathResult<T>>(Ceil(static_cast<double>(value)));
 }
-#endif
 
 template <typename T>
 inline constexpr T round(const T value) {
-  return std::round(value);
+  if constexpr (std::is_integral<T>::value) {
+    return value;
+  } else {
+    return static_cast<T>(Round(static_cast<double>(value)));
+  }
 }
 
 template <typename Input, typename Output>
 inline constexpr Output round(const Input value) {
-  return static_cast<Output>(std::round(value));
+  return static_cast<Output>(round(value));
 }
 
-
 template <typename T>
 inline constexpr T abs(const T t) {
-#ifdef __clang__
   return t > 0 ? t : -t;
-#else
-  return std::abs(t);
-#endif
 }
 
 template <typename T>
 constexpr T AbsDiff(const T a, const T b) {
   return a > b ? a - b : b - a;
 }
+
 }  //  namespace Utilities
+
+#endif  //  UTILITIES_MATH_H_
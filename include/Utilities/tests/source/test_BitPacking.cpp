@@ -0,0 +1,101 @@
+/*
+ * Copyright 2020 Electrooptical Innovations
+ * */
+#include <Utilities/BitPacking.h>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+template <typename Codec, typename T>
+void CheckRoundTrip(const std::size_t count) {
+  const std::size_t kBits = Codec::kBitsPerSample;
+  std::mt19937 generator{static_cast<uint32_t>(count + kBits)};
+  std::uniform_int_distribution<int64_t> distribution{
+      -(int64_t{1} << (kBits - 1)), (int64_t{1} << (kBits - 1)) - 1};
+  std::vector<T> samples(count);
+  for (auto& sample : samples) {
+    sample = static_cast<T>(distribution(generator));
+  }
+
+  std::vector<uint8_t> packed(Codec::GetPackedSize(count));
+  EXPECT_EQ(packed.size(), Codec::Pack(samples.data(), samples.size(),
+                                       packed.data(), packed.size()));
+  std::vector<T> unpacked(count);
+  EXPECT_EQ(count, Codec::Unpack(packed.data(), packed.size(),
+                                 unpacked.data(), unpacked.size()));
+  EXPECT_EQ(samples, unpacked);
+}
+
+template <std::size_t kBits, typename T>
+void CheckAllLayouts() {
+  using Utilities::ByteOrder;
+  using Utilities::PackedSamples;
+  using Utilities::SamplePacking;
+  for (std::size_t count : {0, 1, 2, 3, 7, 8, 9, 1001}) {
+    CheckRoundTrip<PackedSamples<kBits, ByteOrder::kLsbFirst>, T>(count);
+    CheckRoundTrip<PackedSamples<kBits, ByteOrder::kMsbFirst>, T>(count);
+    CheckRoundTrip<
+        PackedSamples<kBits, ByteOrder::kLsbFirst, SamplePacking::kWord>, T>(
+        count);
+    CheckRoundTrip<
+        PackedSamples<kBits, ByteOrder::kMsbFirst, SamplePacking::kWord>, T>(
+        count);
+  }
+}
+}  //  namespace
+
+TEST(BitPacking, TwelveBitLayout) {
+  const std::array<int16_t, 2> samples{-1348, 0x123};  //  0xabc, 0x123
+  std::array<uint8_t, 3> packed{};
+  using Msb = Utilities::PackedSamples<12, Utilities::ByteOrder::kMsbFirst>;
+  using Lsb = Utilities::PackedSamples<12, Utilities::ByteOrder::kLsbFirst>;
+
+  EXPECT_EQ(3u, Msb::Pack(samples.data(), samples.size(), packed.data(),
+                          packed.size()));
+  EXPECT_EQ((std::array<uint8_t, 3>{0xab, 0xc1, 0x23}), packed);
+  EXPECT_EQ(3u, Lsb::Pack(samples.data(), samples.size(), packed.data(),
+                          packed.size()));
+  EXPECT_EQ((std::array<uint8_t, 3>{0xbc, 0x3a, 0x12}), packed);
+
+  std::array<uint16_t, 2> raw{};
+  Lsb::Unpack(packed.data(), packed.size(), raw.data(), raw.size());
+  EXPECT_EQ(0xabc, raw[0]);
+  EXPECT_EQ(0x123, raw[1]);
+}
+
+TEST(BitPacking, ThreeByteWords) {
+  const std::array<uint8_t, 6> data{0xff, 0xff, 0xfe, 0x00, 0x00, 0x7f};
+  std::array<int32_t, 2> samples{};
+  using Codec =
+      Utilities::PackedSamples<24, Utilities::ByteOrder::kMsbFirst,
+                               Utilities::SamplePacking::kWord>;
+  EXPECT_EQ(2u, Codec::Unpack(data.data(), data.size(), samples.data(),
+                              samples.size()));
+  EXPECT_EQ(-2, samples[0]);
+  EXPECT_EQ(0x7f, samples[1]);
+}
+
+TEST(BitPacking, ShortBuffer) {
+  using Codec = Utilities::PackedSamples<14>;
+  const std::array<int16_t, 4> samples{1, -2, 3, -4};
+  std::array<uint8_t, 6> packed{};
+  EXPECT_EQ(0u, Codec::Pack(samples.data(), samples.size(), packed.data(),
+                            packed.size()));
+  std::array<int16_t, 4> out{};
+  //  6 bytes only hold 3 whole 14 bit samples
+  EXPECT_EQ(3u, Codec::Unpack(packed.data(), packed.size(), out.data(),
+                              out.size()));
+}
+
+TEST(BitPacking, RoundTrip) {
+  CheckAllLayouts<12, int16_t>();
+  CheckAllLayouts<14, int16_t>();
+  CheckAllLayouts<16, int16_t>();
+  CheckAllLayouts<18, int32_t>();
+  CheckAllLayouts<24, int32_t>();
+  CheckAllLayouts<32, int32_t>();
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright 2020 Electrooptical Innovations
+ * */
+#include <RingBuffer/RingBuffer.h>
+#include <Utilities/DeltaCodec.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+using Codec = Utilities::DeltaBlockCodec<int16_t, 128>;
+
+std::vector<int16_t> MakeCapture(const std::size_t count) {
+  //  slow ramp with a few LSBs of noise like a raw ADC capture
+  std::mt19937 generator{1234};
+  std::uniform_int_distribution<int> noise{-3, 3};
+  std::vector<int16_t> samples(count);
+  for (std::size_t i = 0; i < count; i++) {
+    samples[i] = static_cast<int16_t>(static_cast<int>(i / 4 % 8192) - 4096 +
+                                      noise(generator));
+  }
+  return samples;
+}
+}  //  namespace
+
+TEST(DeltaCodec, BitPackRoundTrip) {
+  std::mt19937 generator{42};
+  for (std::size_t bits = 0; bits <= 32; bits++) {
+    const uint64_t mask = (uint64_t{1} << bits) - 1;
+    std::vector<uint32_t> values(131);
+    for (auto& value : values) {
+      value = static_cast<uint32_t>(generator() & mask);
+    }
+    std::vector<uint8_t> packed(
+        Utilities::CalcNumberOfBytesToFitBits(values.size() * bits));
+    EXPECT_EQ(packed.size(),
+              Utilities::PackBits(values.data(), values.size(), bits,
+                                  packed.data()));
+    std::vector<uint32_t> out(values.size());
+    EXPECT_EQ(values.size(),
+              Utilities::UnpackBits(packed.data(), packed.size(), bits,
+                                    out.data(), out.size()));
+    EXPECT_EQ(values, out);
+  }
+}
+
+TEST(DeltaCodec, CompressesSlowSignal) {
+  const auto samples = MakeCapture(16384 + 37);
+  std::vector<uint8_t> encoded(Codec::GetBlockCount(samples.size()) *
+                               Codec::kMaxEncodedBlockSize);
+  const std::size_t size =
+      Codec::Encode(samples.data(), samples.size(), encoded.data(),
+                    encoded.size());
+  ASSERT_GT(size, 0u);
+  EXPECT_LT(size * 3, samples.size() * sizeof(int16_t));
+
+  std::vector<int16_t> decoded(samples.size());
+  EXPECT_EQ(samples.size(), Codec::Decode(encoded.data(), size, decoded.data(),
+                                          decoded.size()));
+  EXPECT_EQ(samples, decoded);
+}
+
+TEST(DeltaCodec, FullScaleJumps) {
+  std::vector<int16_t> samples;
+  for (int i = 0; i < 300; i++) {
+    samples.push_back(i % 2 ? std::numeric_limits<int16_t>::min()
+                            : std::numeric_limits<int16_t>::max());
+  }
+  std::vector<uint8_t> encoded(Codec::GetBlockCount(samples.size()) *
+                               Codec::kMaxEncodedBlockSize);
+  const std::size_t size = Codec::Encode(samples.data(), samples.size(),
+                                         encoded.data(), encoded.size());
+  ASSERT_GT(size, 0u);
+  std::vector<int16_t> decoded(samples.size());
+  Codec::Decode(encoded.data(), size, decoded.data(), decoded.size());
+  EXPECT_EQ(samples, decoded);
+
+  //  truncated output is reported rather than overrun
+  EXPECT_EQ(0u, Codec::Encode(samples.data(), samples.size(), encoded.data(),
+                              size - 1));
+}
+
+TEST(DeltaCodec, RandomAccess) {
+  const auto samples = MakeCapture(1000);
+  std::vector<uint8_t> encoded(Codec::GetBlockCount(samples.size()) *
+                               Codec::kMaxEncodedBlockSize);
+  std::vector<uint32_t> offsets(Codec::GetBlockCount(samples.size()));
+  const std::size_t size =
+      Codec::Encode(samples.data(), samples.size(), encoded.data(),
+                    encoded.size(), offsets.data());
+  ASSERT_GT(size, 0u);
+
+  for (std::size_t block = offsets.size(); block-- > 0;) {
+    std::array<int16_t, 128> out{};
+    const std::size_t count = Codec::DecodeBlockAt(
+        encoded.data(), size, offsets.data(), block, samples.size(),
+        out.data());
+    EXPECT_EQ(Codec::GetBlockSampleCount(block, samples.size()), count);
+    for (std::size_t i = 0; i < count; i++) {
+      EXPECT_EQ(samples[block * 128 + i], out[i]);
+    }
+  }
+  //  past the last block, the offsets are not read
+  std::array<int16_t, 128> out{};
+  EXPECT_EQ(0u, Codec::DecodeBlockAt(encoded.data(), size, offsets.data(),
+                                     offsets.size(), samples.size(),
+                                     out.data()));
+}
+
+TEST(DeltaCodec, StreamFromRingBuffer) {
+  const auto samples = MakeCapture(1000);
+  RingBuffer<int16_t, 512> ring;
+  std::vector<uint8_t> encoded(Codec::GetBlockCount(samples.size()) *
+                               Codec::kMaxEncodedBlockSize);
+  std::size_t offset = 0;
+  std::size_t inserted = 0;
+  while (inserted < samples.size()) {
+    const std::size_t chunk =
+        std::min<std::size_t>(200, samples.size() - inserted);
+    inserted += ring.insert(&samples[inserted], chunk);
+    offset += Codec::EncodeFromBuffer(&ring, &encoded[offset],
+                                      encoded.size() - offset);
+    EXPECT_LT(ring.GetCount(), 128u);
+  }
+  offset += Codec::EncodeFromBuffer(&ring, &encoded[offset],
+                                    encoded.size() - offset, true);
+  EXPECT_TRUE(ring.isEmpty());
+
+  std::vector<int16_t> decoded(samples.size());
+  EXPECT_EQ(samples.size(), Codec::Decode(encoded.data(), offset,
+                                          decoded.data(), decoded.size()));
+  EXPECT_EQ(samples, decoded);
+}
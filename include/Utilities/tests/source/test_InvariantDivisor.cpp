@@ -0,0 +1,87 @@
+/*
+ * Copyright 2020 Electrooptical Innovations
+ * */
+#include <Utilities/InvariantDivisor.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+TEST(InvariantDivisor, MultiplyHigh) {
+  EXPECT_EQ(0, Utilities::InvariantDivision::MultiplyHigh(1, ~uint64_t{0}));
+  EXPECT_EQ(~uint64_t{0} - 1, Utilities::InvariantDivision::MultiplyHigh(
+                                  ~uint64_t{0}, ~uint64_t{0}));
+  EXPECT_EQ(1, Utilities::InvariantDivision::MultiplyHigh(uint64_t{1} << 32,
+                                                          uint64_t{1} << 32));
+}
+
+TEST(InvariantDivisor, MatchesDivision) {
+  std::mt19937_64 generator{9};
+  std::vector<uint64_t> divisors{1, 2, 3, 5, 7, 10, 641, 3300000, 20000000,
+                                 (uint64_t{1} << 32) - 1, uint64_t{1} << 32,
+                                 (uint64_t{1} << 63) - 1, uint64_t{1} << 63,
+                                 (uint64_t{1} << 63) + 1, ~uint64_t{0}};
+  for (int i = 0; i < 200; i++) {
+    divisors.push_back(generator() >> (generator() % 64) | 1);
+  }
+  for (const uint64_t divisor : divisors) {
+    const Utilities::InvariantDivisor<> prepared{divisor};
+    std::vector<uint64_t> dividends{0, 1, divisor - 1, divisor, divisor + 1,
+                                    ~uint64_t{0}, ~uint64_t{0} - 1};
+    for (int i = 0; i < 200; i++) {
+      dividends.push_back(generator() >> (generator() % 64));
+    }
+    for (const uint64_t dividend : dividends) {
+      ASSERT_EQ(dividend / divisor, prepared.divide(dividend))
+          << dividend << " / " << divisor;
+    }
+  }
+}
+
+namespace {
+template <typename T>
+void CheckType(const unsigned seed) {
+  std::mt19937_64 generator{seed};
+  std::vector<T> values{1,
+                        2,
+                        3,
+                        7,
+                        std::numeric_limits<T>::max(),
+                        std::numeric_limits<T>::min(),
+                        static_cast<T>(std::numeric_limits<T>::max() - 1),
+                        static_cast<T>(std::numeric_limits<T>::min() + 1)};
+  if (std::numeric_limits<T>::is_signed) {
+    values.push_back(static_cast<T>(-1));
+    values.push_back(static_cast<T>(-2));
+    values.push_back(static_cast<T>(-7));
+  }
+  for (int i = 0; i < 300; i++) {
+    values.push_back(static_cast<T>(generator() >> (generator() % 64)));
+  }
+  for (const T divisor : values) {
+    if (divisor == 0) {
+      continue;
+    }
+    const Utilities::InvariantDivisor<T> prepared{divisor};
+    for (const T dividend : values) {
+      //  the one quotient that does not fit in T
+      if (std::numeric_limits<T>::is_signed &&
+          dividend == std::numeric_limits<T>::min() &&
+          divisor == static_cast<T>(-1)) {
+        continue;
+      }
+      ASSERT_EQ(static_cast<T>(dividend / divisor), prepared.divide(dividend))
+          << dividend << " / " << divisor;
+    }
+  }
+}
+}  //  namespace
+
+TEST(InvariantDivisor, AllTypes) {
+  CheckType<uint32_t>(1);
+  CheckType<int32_t>(2);
+  CheckType<uint64_t>(3);
+  CheckType<int64_t>(4);
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright 2020 Electrooptical Innovations
+ * */
+#include <Utilities/NumberFormat.h>
+#include <Utilities/TypeConversion.h>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+template <typename T>
+std::string Format(const T value) {
+  std::array<char, Utilities::kMaxDecimalChars<T>> text{};
+  const std::size_t length = Utilities::FormatDecimal(value, text.data());
+  return std::string(text.data(), length);
+}
+
+std::string FormatMicro(const int64_t value) {
+  std::array<char, Utilities::kMaxMicroChars> text{};
+  const std::size_t length = Utilities::FormatMicro(value, text.data());
+  return std::string(text.data(), length);
+}
+
+template <typename T>
+void CheckAgainstToString(const std::vector<T>& values) {
+  for (const auto value : values) {
+    EXPECT_EQ(std::to_string(value), Format(value));
+  }
+}
+
+template <typename T>
+std::vector<T> MakeValues() {
+  std::vector<T> values{0,
+                        1,
+                        9,
+                        10,
+                        99,
+                        100,
+                        std::numeric_limits<T>::max(),
+                        std::numeric_limits<T>::min()};
+  T power = 1;
+  while (power <= std::numeric_limits<T>::max() / 10) {
+    power = static_cast<T>(power * 10);
+    values.push_back(power);
+    values.push_back(static_cast<T>(power - 1));
+  }
+  std::mt19937_64 generator{7};
+  for (int i = 0; i < 1000; i++) {
+    values.push_back(static_cast<T>(generator()));
+    values.push_back(static_cast<T>(generator() >> (generator() % 64)));
+  }
+  return values;
+}
+}  //  namespace
+
+TEST(NumberFormat, MatchesToString) {
+  CheckAgainstToString(MakeValues<uint32_t>());
+  CheckAgainstToString(MakeValues<int32_t>());
+  CheckAgainstToString(MakeValues<uint64_t>());
+  CheckAgainstToString(MakeValues<int64_t>());
+  CheckAgainstToString(MakeValues<int16_t>());
+}
+
+TEST(NumberFormat, Micro) {
+  EXPECT_EQ("25.000000", FormatMicro(25000000));
+  EXPECT_EQ("0.000001", FormatMicro(1));
+  EXPECT_EQ("-0.000001", FormatMicro(-1));
+  EXPECT_EQ("-3.300000", FormatMicro(-3300000));
+  EXPECT_EQ("0.000000", FormatMicro(0));
+  EXPECT_EQ("-9223372036854.775808",
+            FormatMicro(std::numeric_limits<int64_t>::min()));
+  EXPECT_EQ(Utilities::kMaxMicroChars,
+            FormatMicro(std::numeric_limits<int64_t>::min()).size());
+}
+
+TEST(NumberFormat, Array) {
+  const std::array<int32_t, 4> values{-12, 0, 345, 2147483647};
+  std::array<char, 64> text{};
+  std::size_t length = Utilities::FormatDecimalArray(
+      values.data(), values.size(), ',', text.data(), text.size());
+  EXPECT_EQ("-12,0,345,2147483647", std::string(text.data(), length));
+
+  //  stops before a value that might not fit
+  length = Utilities::FormatDecimalArray(values.data(), values.size(), ',',
+                                         text.data(), 16);
+  EXPECT_EQ("-12,0", std::string(text.data(), length));
+
+  const std::array<int64_t, 2> micro{25000000, -1500};
+  length = Utilities::FormatMicroArray(micro.data(), micro.size(), '\t',
+                                       text.data(), text.size());
+  EXPECT_EQ("25.000000\t-0.001500", std::string(text.data(), length));
+}
+
+TEST(NumberFormat, num2chars) {
+  std::array<char, std::numeric_limits<uint32_t>::digits10> buff{};
+  Utilities::num2chars(1234, buff);
+  EXPECT_EQ("000001234", std::string(buff.data(), buff.size()));
+  Utilities::num2chars(4294967295u, buff);
+  EXPECT_EQ("294967295", std::string(buff.data(), buff.size()));
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright 2020 Electrooptical Innovations
+ * */
+#include <RingBuffer/RingBuffer.h>
+#include <Utilities/SegmentWriter.h>
+#include <Utilities/StructSerializer.h>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace {
+struct Reading {
+  uint16_t channel;
+  int32_t value;
+};
+using ReadingSchema = Utilities::StructSerializer<
+    Reading, Utilities::SchemaField<&Reading::channel>,
+    Utilities::SchemaField<&Reading::value, Utilities::ByteOrder::kMsbFirst>>;
+
+std::vector<uint8_t> WriteFrame(Utilities::SegmentWriter* writer) {
+  writer->WriteInteger<Utilities::ByteOrder::kMsbFirst>(uint32_t{0xa1b2c3d4});
+  writer->WriteVarint(int32_t{-300});
+  writer->WriteStruct<ReadingSchema>(Reading{7, -2});
+  writer->WriteValue(uint16_t{0x0102});
+  const std::array<uint8_t, 3> trailer{0xee, 0xff, 0x00};
+  writer->write(trailer.data(), trailer.size());
+
+  std::vector<uint8_t> expected{0xa1, 0xb2, 0xc3, 0xd4};
+  std::array<uint8_t, 4> varint{};
+  const size_t size = write_varint(varint.data(), varint.size(), int32_t{-300});
+  expected.insert(expected.end(), varint.begin(), varint.begin() + size);
+  const auto reading = ReadingSchema::ToArray(Reading{7, -2});
+  expected.insert(expected.end(), reading.begin(), reading.end());
+  expected.insert(expected.end(), {0x02, 0x01, 0xee, 0xff, 0x00});
+  return expected;
+}
+}  //  namespace
+
+TEST(SegmentWriter, EverySplit) {
+  std::array<uint8_t, 32> contiguous{};
+  Utilities::Segment whole{contiguous.data(), contiguous.size()};
+  Utilities::SegmentWriter reference{&whole, 1};
+  const auto expected = WriteFrame(&reference);
+  ASSERT_EQ(expected.size(), reference.GetBytesWritten());
+  ASSERT_TRUE(std::equal(expected.begin(), expected.end(), contiguous.begin()));
+
+  //  split the same frame over three segments at every pair of positions
+  for (size_t first = 0; first <= expected.size(); first++) {
+    for (size_t second = first; second <= expected.size(); second++) {
+      std::vector<uint8_t> storage(expected.size());
+      const std::array<Utilities::Segment, 3> segments{
+          Utilities::Segment{storage.data(), first},
+          Utilities::Segment{&storage[first], second - first},
+          Utilities::Segment{&storage[second], expected.size() - second}};
+      Utilities::SegmentWriter writer{segments.data(), segments.size()};
+      WriteFrame(&writer);
+      EXPECT_EQ(expected.size(), writer.GetBytesWritten());
+      EXPECT_EQ(0, writer.GetRemaining());
+      EXPECT_EQ(expected, storage);
+    }
+  }
+}
+
+TEST(SegmentWriter, Overflow) {
+  std::array<uint8_t, 5> storage{};
+  const std::array<Utilities::Segment, 2> segments{
+      Utilities::Segment{storage.data(), 2},
+      Utilities::Segment{&storage[2], 3}};
+  Utilities::SegmentWriter writer{segments.data(), segments.size()};
+  EXPECT_EQ(4, writer.WriteInteger<Utilities::ByteOrder::kLsbFirst>(
+                   uint32_t{0x04030201}));
+  //  nothing is written when the value does not fit
+  EXPECT_EQ(0, writer.WriteInteger<Utilities::ByteOrder::kLsbFirst>(
+                   uint16_t{0xffff}));
+  EXPECT_EQ(0, writer.WriteVarint(uint32_t{300}));
+  EXPECT_EQ(1, writer.WriteVarint(uint32_t{5}));
+  EXPECT_EQ(0, writer.GetRemaining());
+  const std::array<uint8_t, 5> expected{1, 2, 3, 4, 5};
+  EXPECT_EQ(expected, storage);
+}
+
+TEST(SegmentWriter, RingBufferRegions) {
+  RingBuffer<uint8_t, 16> ring;
+  std::array<uint8_t, 12> fill{};
+  ring.insert(fill.data(), fill.size());
+  ring.pop(fill.data(), 10);
+  //  head at 12, tail at 10: 4 free bytes at the end and 10 at the start
+  EXPECT_EQ(14, ring.GetFreeCount());
+
+  std::array<Utilities::Segment, 2> segments{};
+  ASSERT_EQ(2, Utilities::GetFreeSegments(&ring, segments.data()));
+  EXPECT_EQ(4, segments[0].size);
+  EXPECT_EQ(10, segments[1].size);
+
+  Utilities::SegmentWriter writer{segments.data(), segments.size()};
+  for (uint8_t i = 0; i < 6; i++) {
+    writer.WriteValue(i);
+  }
+  EXPECT_EQ(6, ring.CommitInsert(writer.GetBytesWritten()));
+  EXPECT_EQ(8, ring.GetCount());
+
+  std::array<uint8_t, 8> out{};
+  EXPECT_EQ(8, ring.pop(out.data(), out.size()));
+  const std::array<uint8_t, 8> expected{0, 0, 0, 1, 2, 3, 4, 5};
+  EXPECT_EQ(expected, out);
+  EXPECT_EQ(16, ring.GetFreeCount());
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright 2020 Electrooptical Innovations
+ * */
+#include <Utilities/Serializer.h>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+template <typename T>
+void CheckRoundTrip(const T value) {
+  std::array<uint8_t, Varint::kMaxSize<T>> storage{};
+  const size_t size = write_varint(storage.data(), storage.size(), value);
+  ASSERT_EQ(varint_size(value), size);
+  T out{};
+  EXPECT_EQ(size, read_varint(storage.data(), size, &out));
+  EXPECT_EQ(value, out);
+
+  //  same value decoded through the word at a time path
+  std::array<uint8_t, 16> padded{};
+  write_varint(padded.data(), padded.size(), value);
+  out = T{};
+  EXPECT_EQ(size, read_varint(padded.data(), padded.size(), &out));
+  EXPECT_EQ(value, out);
+}
+
+template <typename T>
+void CheckLimits() {
+  CheckRoundTrip<T>(0);
+  CheckRoundTrip<T>(1);
+  CheckRoundTrip<T>(std::numeric_limits<T>::max());
+  CheckRoundTrip<T>(std::numeric_limits<T>::min());
+  std::mt19937_64 generator{3};
+  for (int i = 0; i < 1000; i++) {
+    CheckRoundTrip(static_cast<T>(generator() >> (generator() % 64)));
+  }
+}
+}  //  namespace
+
+TEST(Varint, Encoding) {
+  std::array<uint8_t, 4> storage{};
+  EXPECT_EQ(1, write_varint(storage.data(), storage.size(), uint32_t{0x7f}));
+  EXPECT_EQ(0x7f, storage[0]);
+  EXPECT_EQ(2, write_varint(storage.data(), storage.size(), uint32_t{300}));
+  EXPECT_EQ(0xac, storage[0]);
+  EXPECT_EQ(0x02, storage[1]);
+  EXPECT_EQ(1, write_varint(storage.data(), storage.size(), int32_t{-1}));
+  EXPECT_EQ(0x01, storage[0]);
+  EXPECT_EQ(0, write_varint(storage.data(), 1, uint32_t{300}));
+  EXPECT_EQ(5, varint_size(std::numeric_limits<uint32_t>::max()));
+  EXPECT_EQ(10, varint_size(std::numeric_limits<int64_t>::min()));
+}
+
+TEST(Varint, RoundTrip) {
+  CheckLimits<uint8_t>();
+  CheckLimits<int16_t>();
+  CheckLimits<uint32_t>();
+  CheckLimits<int32_t>();
+  CheckLimits<uint64_t>();
+  CheckLimits<int64_t>();
+}
+
+TEST(Varint, Malformed) {
+  uint32_t value = 0;
+  //  truncated
+  const std::array<uint8_t, 2> truncated{0x80, 0x80};
+  EXPECT_EQ(0, read_varint(truncated.data(), truncated.size(), &value));
+  //  does not fit in the output type
+  std::array<uint8_t, 16> storage{};
+  write_varint(storage.data(), storage.size(), uint64_t{1} << 40);
+  EXPECT_EQ(0, read_varint(storage.data(), storage.size(), &value));
+  EXPECT_EQ(0, read_varint(storage.data(), 6, &value));
+  //  11 byte value is longer than any uint64_t
+  std::array<uint8_t, 11> overlong{};
+  overlong.fill(0x80);
+  overlong.back() = 0;
+  uint64_t wide = 0;
+  EXPECT_EQ(0, read_varint(overlong.data(), overlong.size(), &wide));
+}
+
+TEST(Varint, Array) {
+  std::mt19937 generator{5};
+  std::vector<int32_t> values(1000);
+  for (size_t i = 0; i < values.size(); i++) {
+    //  mostly small deltas so the eight byte fast path runs
+    values[i] = i % 50 ? static_cast<int32_t>(generator() % 100) - 50
+                       : static_cast<int32_t>(generator());
+  }
+  std::vector<uint8_t> storage(values.size() * Varint::kMaxSize<int32_t>);
+  const size_t size = write_varint_array(storage.data(), storage.size(),
+                                         values.data(), values.size());
+  ASSERT_GT(size, 0);
+  EXPECT_LT(size, values.size() * sizeof(int32_t) / 2);
+
+  std::vector<int32_t> out(values.size());
+  EXPECT_EQ(size, read_varint_array(storage.data(), size, out.data(),
+                                    out.size()));
+  EXPECT_EQ(values, out);
+
+  EXPECT_EQ(0, read_varint_array(storage.data(), size - 1, out.data(),
+                                 out.size()));
+  EXPECT_EQ(0, write_varint_array(storage.data(), size - 1, values.data(),
+                                  values.size()));
+}
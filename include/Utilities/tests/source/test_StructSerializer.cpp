@@ -0,0 +1,102 @@
+/*
+ * Copyright 2020 Electrooptical Innovations
+ * */
+#include <Utilities/StructSerializer.h>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace {
+enum class Command : uint8_t { kRead = 3, kWrite = 16 };
+
+struct Message {
+  uint16_t address = 0;
+  int32_t value = 0;
+  Command command = Command::kRead;
+  float gain = 0;
+  std::array<uint16_t, 3> registers{};
+  bool enabled = false;
+};
+
+using MessageSerializer = Utilities::StructSerializer<
+    Message, Utilities::SchemaField<&Message::address>,
+    Utilities::SchemaField<&Message::value, Utilities::ByteOrder::kMsbFirst>,
+    Utilities::SchemaField<&Message::command>,
+    Utilities::SchemaField<&Message::gain>,
+    Utilities::SchemaField<&Message::registers,
+                           Utilities::ByteOrder::kMsbFirst>,
+    Utilities::SchemaField<&Message::enabled>>;
+
+static_assert(MessageSerializer::kSize == 2 + 4 + 1 + 4 + 6 + 1);
+static_assert(MessageSerializer::kFieldCount == 6);
+static_assert(MessageSerializer::GetFieldOffset(2) == 6);
+
+struct Header {
+  uint8_t slave = 0;
+  uint16_t length = 0;
+};
+using HeaderSerializer = Utilities::StructSerializer<
+    Header, Utilities::SchemaField<&Header::slave>,
+    Utilities::SchemaField<&Header::length, Utilities::ByteOrder::kMsbFirst>>;
+
+constexpr Header kHeader{0x11, 0x1234};
+static_assert(HeaderSerializer::kSize == 3);
+static_assert(HeaderSerializer::ToArray(kHeader)[0] == 0x11);
+static_assert(HeaderSerializer::ToArray(kHeader)[1] == 0x12);
+static_assert(HeaderSerializer::ToArray(kHeader)[2] == 0x34);
+static_assert(HeaderSerializer::FromArray({0x11, 0x12, 0x34}).length ==
+              0x1234);
+}  //  namespace
+
+TEST(StructSerializer, WireLayout) {
+  Message message{};
+  message.address = 0x0102;
+  message.value = 0x03040506;
+  message.command = Command::kWrite;
+  message.gain = 1.0f;
+  message.registers = {0x0708, 0x090a, 0x0b0c};
+  message.enabled = true;
+
+  std::array<uint8_t, MessageSerializer::kSize> storage{};
+  EXPECT_EQ(MessageSerializer::kSize,
+            MessageSerializer::serialize(storage.data(), storage.size(),
+                                         message));
+  const std::array<uint8_t, MessageSerializer::kSize> expected{
+      0x02, 0x01, 0x03, 0x04, 0x05, 0x06, 16,   0x00, 0x00, 0x80,
+      0x3f, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 1};
+  EXPECT_EQ(expected, storage);
+}
+
+TEST(StructSerializer, RoundTrip) {
+  const Message message{0xbeef, -123456, Command::kWrite, -3.25f,
+                        {0xffff, 0, 42}, true};
+  std::vector<uint8_t> storage(MessageSerializer::kSize + 3);
+  EXPECT_EQ(MessageSerializer::kSize,
+            MessageSerializer::serialize(storage.data(), storage.size(),
+                                         message));
+
+  Message out{};
+  EXPECT_EQ(MessageSerializer::kSize,
+            MessageSerializer::deserialize(storage.data(), storage.size(),
+                                           &out));
+  EXPECT_EQ(message.address, out.address);
+  EXPECT_EQ(message.value, out.value);
+  EXPECT_EQ(message.command, out.command);
+  EXPECT_EQ(message.gain, out.gain);
+  EXPECT_EQ(message.registers, out.registers);
+  EXPECT_EQ(message.enabled, out.enabled);
+}
+
+TEST(StructSerializer, ShortStorage) {
+  std::array<uint8_t, MessageSerializer::kSize - 1> storage{};
+  Message message{};
+  EXPECT_EQ(0u, MessageSerializer::serialize(storage.data(), storage.size(),
+                                             message));
+  EXPECT_EQ(0u, MessageSerializer::deserialize(storage.data(), storage.size(),
+                                               &message));
+  for (auto byte : storage) {
+    EXPECT_EQ(0, byte);
+  }
+}
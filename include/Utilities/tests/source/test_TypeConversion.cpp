@@ -0,0 +1,113 @@
+/*
+ * Copyright 2020 Electrooptical Innovations
+ * */
+#include <Utilities/TypeConversion.h>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace {
+template <typename T>
+std::vector<T> MakeRamp(const std::size_t count) {
+  std::vector<T> data(count);
+  for (std::size_t i = 0; i < count; i++) {
+    data[i] = static_cast<T>(i * 2654435761u);
+  }
+  return data;
+}
+
+template <typename T>
+void CheckArrayRoundTrip(const std::size_t count) {
+  const auto data = MakeRamp<T>(count);
+  std::vector<uint8_t> msb(count * sizeof(T));
+  std::vector<uint8_t> lsb(count * sizeof(T));
+  Utilities::ArrayToBytes<T>(data.data(), msb.data(), data.size(), msb.size());
+  Utilities::ArrayToBytes<T, Utilities::ByteOrder::kLsbFirst>(
+      data.data(), lsb.data(), data.size(), lsb.size());
+
+  for (std::size_t i = 0; i < count; i++) {
+    const auto expected = Utilities::MakeMSBU8Array<T>(data[i]);
+    for (std::size_t byte = 0; byte < sizeof(T); byte++) {
+      ASSERT_EQ(expected[byte], msb[i * sizeof(T) + byte]);
+      ASSERT_EQ(expected[byte], lsb[i * sizeof(T) + sizeof(T) - 1 - byte]);
+    }
+  }
+
+  std::vector<T> out(count);
+  Utilities::ArrayFromBytes<T>(msb.data(), out.data(), msb.size(), out.size());
+  EXPECT_EQ(data, out);
+  std::fill(out.begin(), out.end(), T{});
+  Utilities::ArrayFromBytes<T, Utilities::ByteOrder::kLsbFirst>(
+      lsb.data(), out.data(), lsb.size(), out.size());
+  EXPECT_EQ(data, out);
+  std::fill(out.begin(), out.end(), T{});
+  Utilities::ConvertToType<T>(msb.data(), out.data(), msb.size());
+  EXPECT_EQ(data, out);
+}
+}  //  namespace
+
+TEST(TypeConversion, StoreLoadInteger) {
+  std::array<uint8_t, 4> data{};
+  Utilities::StoreInteger<Utilities::ByteOrder::kMsbFirst, int32_t>(
+      0x01020304, data.data());
+  EXPECT_EQ((std::array<uint8_t, 4>{1, 2, 3, 4}), data);
+  EXPECT_EQ(0x04030201, (Utilities::LoadInteger<Utilities::ByteOrder::kLsbFirst,
+                                                int32_t>(data.data())));
+  Utilities::StoreInteger<Utilities::ByteOrder::kLsbFirst, int16_t>(
+      -2, data.data());
+  EXPECT_EQ(0xfe, data[0]);
+  EXPECT_EQ(0xff, data[1]);
+}
+
+TEST(TypeConversion, ArrayBytesRoundTrip) {
+  for (std::size_t count : {0, 1, 7, 33, 10000}) {
+    CheckArrayRoundTrip<uint8_t>(count);
+    CheckArrayRoundTrip<int16_t>(count);
+    CheckArrayRoundTrip<uint16_t>(count);
+    CheckArrayRoundTrip<int32_t>(count);
+    CheckArrayRoundTrip<uint64_t>(count);
+  }
+}
+
+TEST(TypeConversion, ArrayBytesFloat) {
+  const std::array<float, 3> data{1.0f, -2.5f, 1e-20f};
+  std::array<uint8_t, sizeof(data)> bytes{};
+  Utilities::ArrayToBytes<float>(data.data(), bytes.data(), data.size(),
+                                 bytes.size());
+  EXPECT_EQ(0x3f, bytes[0]);
+  EXPECT_EQ(0x80, bytes[1]);
+  EXPECT_EQ(0x00, bytes[3]);
+
+  std::array<float, 3> out{};
+  Utilities::ArrayFromBytes<float>(bytes.data(), out.data(), bytes.size(),
+                                   out.size());
+  EXPECT_EQ(data, out);
+
+  const std::array<double, 2> ddata{3.14159, -1e300};
+  std::array<uint8_t, sizeof(ddata)> dbytes{};
+  std::array<double, 2> dout{};
+  Utilities::ArrayToBytes<double, Utilities::ByteOrder::kLsbFirst>(
+      ddata.data(), dbytes.data(), ddata.size(), dbytes.size());
+  Utilities::ArrayFromBytes<double, Utilities::ByteOrder::kLsbFirst>(
+      dbytes.data(), dout.data(), dbytes.size(), dout.size());
+  EXPECT_EQ(ddata, dout);
+}
+
+TEST(TypeConversion, ArrayBytesTruncates) {
+  const std::array<uint32_t, 4> data{0x01020304, 0x05060708, 0x090a0b0c,
+                                     0x0d0e0f10};
+  std::array<uint8_t, 11> bytes{};
+  Utilities::ArrayToBytes<uint32_t>(data.data(), bytes.data(), data.size(),
+                                    bytes.size());
+  EXPECT_EQ(0x08, bytes[7]);
+  EXPECT_EQ(0x00, bytes[8]);
+
+  std::array<uint32_t, 4> out{};
+  Utilities::ArrayFromBytes<uint32_t>(bytes.data(), out.data(), bytes.size(),
+                                      out.size());
+  EXPECT_EQ(data[1], out[1]);
+  EXPECT_EQ(0u, out[2]);
+}
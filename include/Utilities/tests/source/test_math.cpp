@@ -0,0 +1,171 @@
+/*
+ * Copyright 2020 Electrooptical Innovations
+ * */
+#include <Utilities/math.h>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace {
+using Utilities::MathAccuracy;
+
+static_assert(Utilities::Exp(0.0) == 1);
+static_assert(Utilities::Log(1.0) == 0);
+static_assert(Utilities::Pow(2.0, 10.0) == 1024);
+static_assert(Utilities::Pow(2.0, -3.0) == 0.125);
+static_assert(Utilities::AbsDiff(Utilities::Exp(1.0), 2.718281828459045) <
+              1e-15);
+static_assert(Utilities::AbsDiff(Utilities::Log(10.0), 2.302585092994046) <
+              1e-15);
+static_assert(Utilities::Round(2.5) == 3 && Utilities::Round(-2.5) == -3);
+static_assert(Utilities::Round(0.49999999999999994) == 0);
+static_assert(Utilities::Floor(-1.5) == -2 && Utilities::Ceil(-1.5) == -1);
+static_assert(Utilities::round<double, int32_t>(-0.6) == -1);
+
+const std::array<double, 8> kValues{1e-310, 1e-12, 0.3, 1,
+                                    2.5,    123.456, 7e10, 1e300};
+
+constexpr std::array<double, kValues.size()> CompileTimeLog(void) {
+  std::array<double, kValues.size()> out{};
+  for (std::size_t i = 0; i < kValues.size(); i++) {
+    out[i] = Utilities::Log(kValues[i]);
+  }
+  return out;
+}
+
+constexpr std::array<double, kValues.size()> CompileTimeExp(void) {
+  std::array<double, kValues.size()> out{};
+  for (std::size_t i = 0; i < kValues.size(); i++) {
+    //  spans underflow to overflow
+    out[i] = Utilities::Exp(Utilities::Log(kValues[i]) * 2.4 - 30);
+  }
+  return out;
+}
+
+double RelativeError(const double expected, const double value) {
+  return std::abs(expected - value) /
+         std::max(std::abs(expected), std::numeric_limits<double>::min());
+}
+}  // namespace
+
+TEST(math, CompileTimeMatchesRuntime) {
+  constexpr auto kLog = CompileTimeLog();
+  constexpr auto kExp = CompileTimeExp();
+  for (std::size_t i = 0; i < kValues.size(); i++) {
+    volatile double value = kValues[i];
+    EXPECT_EQ(kLog[i], Utilities::Log(value)) << i;
+    EXPECT_EQ(kExp[i], Utilities::Exp(Utilities::Log(value) * 2.4 - 30)) << i;
+  }
+}
+
+TEST(math, ExactTier) {
+  for (double x = -745; x < 709.7; x += 0.0731) {
+    const double expected = std::exp(x);
+    if (expected >= std::numeric_limits<double>::min()) {
+      ASSERT_LE(RelativeError(expected, Utilities::Exp(x)), 4e-16) << x;
+    }
+  }
+  for (double x = 1e-320; x < 1e308; x *= 1.713) {
+    ASSERT_LE(std::abs(std::log(x) - Utilities::Log(x)),
+              4e-16 * std::max(1.0, std::abs(std::log(x))))
+        << x;
+  }
+  for (double base = 0.01; base < 100; base *= 1.37) {
+    for (const double exponent : {-7.3, -0.5, 0.25, 3.0, 11.9}) {
+      ASSERT_LE(RelativeError(std::pow(base, exponent),
+                              Utilities::Pow(base, exponent)),
+                2e-14)
+          << base << "^" << exponent;
+    }
+  }
+  EXPECT_EQ(-8, Utilities::Pow(-2.0, 3.0));
+  EXPECT_NEAR(-std::pow(2.0, 65.0), Utilities::Pow(-2.0, 65.0), 1e5);
+  EXPECT_TRUE(std::isnan(Utilities::Pow(-2.0, 0.5)));
+}
+
+TEST(math, FastTier) {
+  for (double x = -700; x < 700; x += 0.0917) {
+    ASSERT_LE(
+        RelativeError(std::exp(x), Utilities::Exp<MathAccuracy::kFast>(x)),
+        2e-7)
+        << x;
+  }
+  for (double x = 1e-300; x < 1e300; x *= 1.0713) {
+    ASSERT_LE(std::abs(std::log(x) - Utilities::Log<MathAccuracy::kFast>(x)),
+              2e-7 * std::max(1.0, std::abs(std::log(x))))
+        << x;
+  }
+}
+
+TEST(math, SpecialValues) {
+  const double kInfinity = std::numeric_limits<double>::infinity();
+  const double kNan = std::numeric_limits<double>::quiet_NaN();
+  EXPECT_EQ(0, Utilities::Exp(-1000.0));
+  EXPECT_EQ(kInfinity, Utilities::Exp(1000.0));
+  EXPECT_TRUE(std::isfinite(Utilities::Exp(709.78)));
+  EXPECT_TRUE(std::isnan(Utilities::Exp(kNan)));
+  EXPECT_EQ(-kInfinity, Utilities::Log(0.0));
+  EXPECT_EQ(kInfinity, Utilities::Log(kInfinity));
+  EXPECT_TRUE(std::isnan(Utilities::Log(-1.0)));
+  EXPECT_TRUE(std::isnan(Utilities::Log(kNan)));
+  EXPECT_EQ(1e300, Utilities::Round(1e300));
+  EXPECT_EQ(-4, Utilities::Floor(-3.0000001));
+  EXPECT_EQ(4, Utilities::Ceil(3.0000001));
+}
+
+TEST(math, ArrayMatchesScalar) {
+  std::vector<double> values;
+  for (double x = 1e-5; x < 1e5; x *= 1.1) {
+    values.push_back(x);
+  }
+  std::vector<double> out(values.size());
+  Utilities::Log(values.data(), values.size(), out.data());
+  for (std::size_t i = 0; i < values.size(); i++) {
+    EXPECT_EQ(Utilities::Log<MathAccuracy::kFast>(values[i]), out[i]);
+  }
+  Utilities::Exp<MathAccuracy::kExact>(out.data(), out.size(), out.data());
+  for (std::size_t i = 0; i < values.size(); i++) {
+    EXPECT_LE(RelativeError(values[i], out[i]), 1e-6);
+  }
+  Utilities::Pow(values.data(), 0.5, values.size(), out.data());
+  for (std::size_t i = 0; i < values.size(); i++) {
+    EXPECT_EQ(Utilities::Pow<MathAccuracy::kFast>(values[i], 0.5), out[i]);
+  }
+}
+
+TEST(math, ArrayPowMatchesScalar) {
+  std::vector<double> bases;
+  for (double x = -50; x < 50; x += 0.37) {
+    bases.push_back(x);
+  }
+  bases.push_back(0.0);
+  bases.push_back(-0.0);
+  std::vector<double> out(bases.size());
+  for (const double exponent : {-7.0, -1.0, 0.0, 2.0, 13.0, 64.0, 65.0, 0.5,
+                                -2.25, 100.0}) {
+    Utilities::Pow<MathAccuracy::kExact>(bases.data(), exponent, bases.size(),
+                                         out.data());
+    for (std::size_t i = 0; i < bases.size(); i++) {
+      const double expected =
+          Utilities::Pow<MathAccuracy::kExact>(bases[i], exponent);
+      if (std::isnan(expected)) {
+        EXPECT_TRUE(std::isnan(out[i])) << bases[i] << "^" << exponent;
+      } else {
+        EXPECT_EQ(expected, out[i]) << bases[i] << "^" << exponent;
+      }
+    }
+  }
+  //  in place
+  std::vector<double> in_place = bases;
+  Utilities::Pow(in_place.data(), 3.0, in_place.size(), in_place.data());
+  for (std::size_t i = 0; i < bases.size(); i++) {
+    EXPECT_EQ(Utilities::Pow<MathAccuracy::kFast>(bases[i], 3.0), in_place[i]);
+  }
+  EXPECT_EQ(0, Utilities::Pow(0.0, 0.5));
+  EXPECT_EQ(std::numeric_limits<double>::infinity(), Utilities::Pow(0.0, -0.5));
+  EXPECT_TRUE(std::isnan(Utilities::Pow(0.0, std::nan(""))));
+}